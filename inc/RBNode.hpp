@@ -12,22 +12,74 @@
 
 #ifndef RBNode_HPP
 # define RBNode_HPP
+# include "node_update.hpp"
+# if defined(FT_COMPACT_NODES) || defined(FT_INDEX_NODES)
+#  include "node_link.hpp"
+# endif
+# if __cplusplus >= 201103L
+#  include <utility>
+# endif
 
 namespace ft
 {
 	enum Color {red, black};
 
-	template <class T>
-	struct RBNode
+	// Node layout depends on the build:
+	//   default            three pointers and a Color
+	//   FT_COMPACT_NODES   three pointers, the color is the lowest bit of parent
+	//   FT_INDEX_NODES     three 32 bit indexes into node_pages, the color is the lowest bit of parent.
+	//                      nodes must come from ft::node_pool, which lays them out in indexed pages
+	// parent, left and right read and assign like RBNode pointers in every layout,
+	// the color goes through getColor() and setColor().
+	// data is built in place from the arguments following the links (forwarded in C++11).
+	// the metadata of the tree's node update policy (see node_update.hpp) is a base class,
+	// so that a policy without any costs no room.
+	// With FT_THREADED_NODES every node also links to its in-order neighbours, through the
+	// tree header at both ends, so that iterators step in a single load
+	template <class T, class NodeUpdate = default_node_update>
+	struct RBNode : public NodeUpdate::metadata
 	{
+# if defined(FT_INDEX_NODES)
+		typedef index_link<RBNode> 		parent_link;
+		typedef index_link<RBNode> 		child_link;
+# elif defined(FT_COMPACT_NODES)
+		typedef tagged_link<RBNode> 	parent_link;
+		typedef RBNode* 				child_link;
+# else
+		typedef RBNode* 				parent_link;
+		typedef RBNode* 				child_link;
+# endif
+
 		T 				data;
-		RBNode*			parent;
-		RBNode*			left;
-		RBNode*			right;
+# ifdef FT_THREADED_NODES
+		child_link		next; // right after data, which a scan reads with it. Set by the tree when the node is linked
+		child_link		prev;
+# endif
+		parent_link		parent;
+		child_link		left;
+		child_link		right;
+# if !defined(FT_COMPACT_NODES) && !defined(FT_INDEX_NODES)
 		Color 			color;
 
-		RBNode(T data, RBNode* parent, RBNode* left, RBNode* right, Color clr): data(data), parent(parent), left(left), right(right), color(clr) {}
-	
+		Color 			getColor() const { return (color); }
+		void 			setColor(Color clr) { color = clr; }
+# else
+		Color 			getColor() const { return (static_cast<Color>(parent.flag())); }
+		void 			setColor(Color clr) { parent.setFlag(clr); }
+# endif
+
+# if __cplusplus >= 201103L
+		template <class... Args>
+		RBNode(RBNode* parent, RBNode* left, RBNode* right, Color clr, Args&&... args): data(std::forward<Args>(args)...), parent(parent), left(left), right(right) { setColor(clr); }
+# else
+		RBNode(RBNode* parent, RBNode* left, RBNode* right, Color clr): data(), parent(parent), left(left), right(right) { setColor(clr); }
+
+		template <class A1>
+		RBNode(RBNode* parent, RBNode* left, RBNode* right, Color clr, const A1 &a1): data(a1), parent(parent), left(left), right(right) { setColor(clr); }
+
+		template <class A1, class A2>
+		RBNode(RBNode* parent, RBNode* left, RBNode* right, Color clr, const A1 &a1, const A2 &a2): data(a1, a2), parent(parent), left(left), right(right) { setColor(clr); }
+# endif
 	};
 }
 
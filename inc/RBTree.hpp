@@ -12,6 +12,7 @@
 
 #ifndef RED_BLACK_TREE_HPP
 # define RED_BLACK_TREE_HPP
+# include <new>
 # include "utility.hpp"
 # include "iterator.hpp"
 # include "algorithm.hpp"
@@ -20,35 +21,52 @@
 
 namespace ft
 {
-	template <class Key, class T, class getKey, class Compare, class Alloc = std::allocator<RBNode<T> > >
+	// orders in which RBTree::compact lays nodes out: in key order, for scans, or
+	// van Emde Boas order, where every subtree of about half the height of its parent
+	// is stored in one piece, for lookups
+	enum NodeLayout {in_order_layout, van_emde_boas_layout};
+
+	// NodeUpdate is the policy keeping per subtree metadata in every node (see node_update.hpp),
+	// Alloc must allocate RBNode<T, NodeUpdate>
+	template <class Key, class T, class getKey, class Compare, class Alloc = std::allocator<RBNode<T> >, class NodeUpdate = default_node_update>
 	class RBTree {
 		public:
 			typedef Key 						key_type;
 			typedef T 							value_type;
 			typedef Compare 					value_compare;
 			typedef Alloc 						allocator_type;
+			typedef NodeUpdate 					node_update;
 			typedef size_t 						size_type;
-			typedef RBNode<value_type> 			node_type;
-			typedef RBNode<value_type>* 		node_ptr;
+			typedef RBNode<value_type, NodeUpdate> 	node_type;
+			typedef node_type* 					node_ptr;
 
 		private:
-			node_ptr 							_root;
-			node_ptr 							_nil;
+			node_ptr 							_header; // parent of the root, its parent is the root, left and right cache the extreme nodes
+			node_ptr 							_nil; // sharedNil(), the leaf of every tree of this type
 			value_compare 						_comp;
 			allocator_type 						_alloc;
+			node_update 						_update;
 			size_type 							_size;
 
 		public:
-			RBTree(const value_compare &comp, const allocator_type &alloc = allocator_type()): _comp(comp), _alloc(alloc), _size(0)	{
-				_nil = _alloc.allocate(1);
-				_alloc.construct(_nil, node_type(value_type(), NULL, NULL, NULL, black));
-				_root = _nil;
+			RBTree(const value_compare &comp, const allocator_type &alloc = allocator_type(), const node_update &update = node_update()): _comp(comp), _alloc(alloc), _update(update), _size(0)	{
+				_nil = sharedNil();
+				_header = _alloc.allocate(1);
+				new (static_cast<void *>(_header)) node_type(_nil, _header, _header, red);
+				closeThreads();
 			}
 
-			virtual ~RBTree() {	clear_h(_root);	_alloc.destroy(_nil); _alloc.deallocate(_nil, 1);}
+			virtual ~RBTree() {
+				clear_h(root());
+				_alloc.destroy(_header);
+				_alloc.deallocate(_header, 1);
+			}
 
-			node_ptr			getRoot() const { return (this->_root); }
+			node_ptr			getRoot() const { return (root()); }
 			node_ptr			getNil() const { return (this->_nil); }
+			node_ptr			getHeader() const { return (this->_header); }
+			const node_update	&getNodeUpdate() const { return (this->_update); }
+			const allocator_type	&getAllocator() const { return (this->_alloc); }
 			size_type			getSize() const { return (this->_size); }
 			size_type			max_size() const { return (_alloc.max_size()); }
 
@@ -56,7 +74,7 @@ namespace ft
 			node_ptr minimum(node_ptr node) const
 			{
 				if (node == _nil)
-					return _root;
+					return root();
 				while (node->left != _nil)
 					node = node->left;
 				return node;
@@ -66,89 +84,392 @@ namespace ft
 			node_ptr maximum(node_ptr node) const
 			{
 				if (node == _nil)
-					return _root;
+					return root();
 				while (node->right != _nil)
 					node = node->right;
 				return node;
 			}
 
-			node_ptr insertNode(const value_type &data)
+			// insert data unless its key is already present, in a single descent.
+			// returns the node holding the key and whether it was inserted
+			ft::pair<node_ptr, bool> insert_unique(const value_type &data) { return (emplace_key(getKey()(data), data)); }
+
+			// emplace_key(k, args): when k is missing, build a node's value from args
+			// in place and link it. Nothing is constructed for a key already present.
+			// emplace_unique(args): build the value first, then link it unless its key
+			// is already present, in which case it is destroyed.
+# if __cplusplus >= 201103L
+			template <class... Args>
+			ft::pair<node_ptr, bool> emplace_key(const key_type &k, Args&&... args)
 			{
-				node_ptr node;
-				node = _alloc.allocate(1);
-				_alloc.construct(node, node_type(data, NULL, _nil, _nil, red));
+				node_ptr	parent;
+				bool		left;
+				node_ptr	x = descend(k, parent, left);
+
+				if (x != _nil)
+					return ft::pair<node_ptr, bool>(x, false);
+				return ft::pair<node_ptr, bool>(linkNode(parent, left, createNode(std::forward<Args>(args)...)), true);
+			}
+
+			template <class... Args>
+			ft::pair<node_ptr, bool> emplace_unique(Args&&... args) { return (insert_node(createNode(std::forward<Args>(args)...))); }
+
+			template <class... Args>
+			node_ptr createNode(Args&&... args)
+			{
+				node_ptr node = _alloc.allocate(1);
+
+				try {
+					new (static_cast<void *>(node)) node_type(NULL, _nil, _nil, red, std::forward<Args>(args)...);
+				}
+				catch (...) {
+					_alloc.deallocate(node, 1);
+					throw;
+				}
+				return (node);
+			}
+# else
+			template <class A1>
+			ft::pair<node_ptr, bool> emplace_key(const key_type &k, const A1 &a1)
+			{
+				node_ptr	parent;
+				bool		left;
+				node_ptr	x = descend(k, parent, left);
+
+				if (x != _nil)
+					return ft::pair<node_ptr, bool>(x, false);
+				return ft::pair<node_ptr, bool>(linkNode(parent, left, createNode(a1)), true);
+			}
+
+			template <class A1, class A2>
+			ft::pair<node_ptr, bool> emplace_key(const key_type &k, const A1 &a1, const A2 &a2)
+			{
+				node_ptr	parent;
+				bool		left;
+				node_ptr	x = descend(k, parent, left);
+
+				if (x != _nil)
+					return ft::pair<node_ptr, bool>(x, false);
+				return ft::pair<node_ptr, bool>(linkNode(parent, left, createNode(a1, a2)), true);
+			}
+
+			template <class A1>
+			ft::pair<node_ptr, bool> emplace_unique(const A1 &a1) { return (insert_node(createNode(a1))); }
+
+			template <class A1, class A2>
+			ft::pair<node_ptr, bool> emplace_unique(const A1 &a1, const A2 &a2) { return (insert_node(createNode(a1, a2))); }
+
+			template <class A1>
+			node_ptr createNode(const A1 &a1)
+			{
+				node_ptr node = _alloc.allocate(1);
+
+				try {
+					new (static_cast<void *>(node)) node_type(NULL, _nil, _nil, red, a1);
+				}
+				catch (...) {
+					_alloc.deallocate(node, 1);
+					throw;
+				}
+				return (node);
+			}
+
+			template <class A1, class A2>
+			node_ptr createNode(const A1 &a1, const A2 &a2)
+			{
+				node_ptr node = _alloc.allocate(1);
+
+				try {
+					new (static_cast<void *>(node)) node_type(NULL, _nil, _nil, red, a1, a2);
+				}
+				catch (...) {
+					_alloc.deallocate(node, 1);
+					throw;
+				}
+				return (node);
+			}
+# endif
 
-				node_ptr y = NULL;
-				node_ptr x = this->_root;
+			// link a node built by createNode unless its key is already present
+			ft::pair<node_ptr, bool> insert_node(node_ptr node)
+			{
+				node_ptr	parent;
+				bool		left;
+				node_ptr	x = descend(getKey()(node->data), parent, left);
+
+				if (x != _nil) {
+					_alloc.destroy(node);
+					_alloc.deallocate(node, 1);
+					return ft::pair<node_ptr, bool>(x, false);
+				}
+				return ft::pair<node_ptr, bool>(linkNode(parent, left, node), true);
+			}
 
-				while (x != _nil) // find node's natural placement
-				{
-					y = x;
-					if (_comp(node->data, x->data))
+			// insert data using hint as a guess of its position: when data belongs right
+			// before or right after hint it is linked in place without searching the tree
+			ft::pair<node_ptr, bool> insert_hint(node_ptr hint, const value_type &data)
+			{
+				const key_type	&k = getKey()(data);
+				node_ptr		other;
+
+				if (hint == _header) { // end(): appending after the maximum
+					if (_size > 0 && _comp(getKey()(_header->right->data), k))
+						return ft::pair<node_ptr, bool>(linkNode(_header->right, false, createNode(data)), true);
+				}
+				else if (_comp(k, getKey()(hint->data))) { // data goes somewhere before hint
+					other = (hint == _header->left) ? _header : predecessor(hint);
+					if (other == _header || _comp(getKey()(other->data), k)) {
+						if (hint->left == _nil)
+							return ft::pair<node_ptr, bool>(linkNode(hint, true, createNode(data)), true);
+						return ft::pair<node_ptr, bool>(linkNode(other, false, createNode(data)), true);
+					}
+				}
+				else if (_comp(getKey()(hint->data), k)) { // data goes somewhere after hint
+					other = (hint == _header->right) ? _header : successor(hint);
+					if (other == _header || _comp(k, getKey()(other->data))) {
+						if (hint->right == _nil)
+							return ft::pair<node_ptr, bool>(linkNode(hint, false, createNode(data)), true);
+						return ft::pair<node_ptr, bool>(linkNode(other, true, createNode(data)), true);
+					}
+				}
+				else
+					return ft::pair<node_ptr, bool>(hint, false);
+				return insert_unique(data); // wrong hint
+			}
+
+			// insert every element of [first, last). An empty tree filled from a sorted
+			// forward range is built directly in O(n) instead of one insertion at a time
+			template <class InputIterator>
+			void insert_range(InputIterator first, InputIterator last) {
+				insert_range(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
+			}
+
+			// make this tree a copy of x, node for node: same shape and colors, no comparison.
+			// nodes already owned by this tree are recycled before any new one is allocated.
+			// The copy is built apart and only becomes the tree once complete: if a copy
+			// throws, the partial copy and the old nodes are freed and the tree is left empty
+			void clone(const RBTree &x)
+			{
+				node_ptr spare = NULL;
+				node_ptr copy;
+
+				if (this == &x)
+					return;
+				_comp = x._comp;
+				_update = x._update;
+				detachNodes(root(), spare);
+				root() = _nil;
+				_size = 0;
+				updateExtremes();
+				rethread();
+				try {
+					copy = cloneHelper(x.root(), x._nil, _header, spare);
+				}
+				catch (...) {
+					freeChain(spare);
+					throw;
+				}
+				freeChain(spare); // this tree was bigger than x
+				root() = copy;
+				_size = x._size;
+				updateExtremes();
+				rethread();
+			}
+
+			// move every node to one block allocated at once, in the given layout, so that
+			// nodes read one after another sit next to each other. Each value is copied once,
+			// or moved in C++11 when its move constructor cannot throw, then the old node is freed.
+			// Alloc must provide allocate_run and next_in_run like ft::node_pool. If a copy throws,
+			// the old nodes still hold every value and the tree is left as it was
+			void compact(NodeLayout layout)
+			{
+				node_ptr 	block;
+				node_ptr 	slot;
+				size_type 	built = 0;
+
+				if (_size == 0)
+					return;
+				block = _alloc.allocate_run(_size);
+				slot = block;
+				if (layout == van_emde_boas_layout)
+					placeVeb(root(), height(root()), slot);
+				else
+					placeInOrder(root(), slot);
+				try	{
+					moveValues(root(), built);
+				}
+				catch (...)	{
+					destroyMoved(root(), built);
+					for (slot = block; built < _size; built++)	{
+						node_ptr next = _alloc.next_in_run(slot);
+						_alloc.deallocate(slot, 1);
+						slot = next;
+					}
+					restoreParents(root(), _header);
+					throw;
+				}
+				root() = relinkMoved(root(), _header);
+				updateExtremes();
+				rethread();
+			}
+
+			// node whose key is equivalent to k, or _nil. Only Compare is used, so
+			// k may be of any type it accepts
+			template <class K>
+			node_ptr searchTree(const K &k) const
+			{
+				node_ptr x = root();
+
+				while (x != _nil)	{
+					if (_comp(k, getKey()(x->data)))
 						x = x->left;
-					else if (_comp(x->data, node->data))
+					else if (_comp(getKey()(x->data), k))
 						x = x->right;
-					else	{
-						_alloc.destroy(node);
-						_alloc.deallocate(node, 1);
-						return _nil;
+					else
+						return (x);
+				}
+				return (_nil);
+			}
+
+			// look every key of [first, last) up and write Iterator(node) to out for each, in the
+			// same order, Iterator(_header) when the key is missing. Up to batch_size descents move
+			// down one level at a time in turn and prefetch the child they move to, so that their
+			// cache misses overlap instead of following one another
+			template <class Iterator, class ForwardIterator, class OutputIterator>
+			OutputIterator findMany(ForwardIterator first, ForwardIterator last, OutputIterator out) const
+			{
+				ForwardIterator	keys[batch_size];
+				node_ptr		node[batch_size];
+				size_type		searching[batch_size]; // the keys still going down, in any order
+				size_type		n, i, j, count;
+
+				while (first != last)	{
+					for (n = 0; n < (size_type)batch_size && first != last; ++n, ++first)	{
+						keys[n] = first;
+						node[n] = root();
+						searching[n] = n;
 					}
+					for (count = n; count != 0; )	{
+						for (j = 0; j < count; )	{
+							i = searching[j];
+							node_ptr x = node[i];
+							if (x == _nil)
+								node[i] = _header;
+							else if (_comp(*keys[i], getKey()(x->data)))	{
+								prefetch(node[i] = x->left);
+								++j;
+								continue;
+							}
+							else if (_comp(getKey()(x->data), *keys[i]))	{
+								prefetch(node[i] = x->right);
+								++j;
+								continue;
+							}
+							searching[j] = searching[--count];
+						}
+					}
+					for (i = 0; i < n; ++i)
+						*out++ = Iterator(node[i]);
 				}
-				node->parent = y;
-				if (y == NULL)
-					this->_root = node;
-				else if (_comp(node->data, y->data)) // place the new node at it's right placement
-					y->left = node;
-				else
-					y->right = node;
-				this->_size++;
-				// if new node is a root node, simply return
-				if (y == NULL)	{
-					node->color = black;
-					return (this->_root);
+				return (out);
+			}
+
+			// first node whose key is not less than k, or _header
+			template <class K>
+			node_ptr lower_bound_node(const K &k) const
+			{
+				node_ptr x = root();
+				node_ptr res = _header;
+
+				while (x != _nil)	{
+					if (!_comp(getKey()(x->data), k)) { // x is a candidate, look for a smaller one on the left
+						res = x;
+						x = x->left;
+					}
+					else
+						x = x->right;
 				}
-				// if the grandparent is null, simply return
-				if (node->parent->parent == NULL)
-					return (node);
-				// Fix the tree colors
-				fixInsert(node);
-				return (node);
+				return res;
 			}
 
-			// search the tree for the key k and return the corresponding node
-			node_ptr searchTree(key_type k) const {	return searchTreeHelper(this->_root, k); }
+			// first node whose key is greater than k, or _header
+			template <class K>
+			node_ptr upper_bound_node(const K &k) const
+			{
+				node_ptr x = root();
+				node_ptr res = _header;
 
-			void clear_h(node_ptr const &node) {clear_helper(node);	this->_root = _nil;	}
+				while (x != _nil)	{
+					if (_comp(k, getKey()(x->data))) {
+						res = x;
+						x = x->left;
+					}
+					else
+						x = x->right;
+				}
+				return res;
+			}
+
+			void clear_h(node_ptr const &node) {
+				clear_helper(node);
+				root() = _nil;
+				_header->left = _header;
+				_header->right = _header;
+				closeThreads();
+			}
 
 			void swap(RBTree &x) {
-				std::swap(this->_root, x._root);
+				std::swap(this->_header, x._header);
 				std::swap(this->_size, x._size);
-				std::swap(this->_nil, x._nil);
+				std::swap(this->_comp, x._comp);
+				std::swap(this->_update, x._update);
+				std::swap(this->_alloc, x._alloc); // the nodes go back to the pool they came from
 			}
 
-			bool deleteNode(key_type key)	{
+			template <class K>
+			bool deleteNode(const K &key)	{
 				// find the node containing key
-				node_ptr z, x, y;
+				node_ptr z = searchTree(key);
 
-				z = searchTree(key);
 				if (z == _nil)
 					return false;
+				eraseNode(z);
+				return true;
+			}
+
+			// unlink z and free it, without searching for it
+			void eraseNode(node_ptr z)	{
+				unlinkNode(z);
+				_alloc.destroy(z);
+				_alloc.deallocate(z, 1);
+			}
+
+			// take z out of the tree and rebalance, leaving z itself untouched
+			void unlinkNode(node_ptr z)	{
+				node_ptr x, y, changed; // changed: lowest node whose subtree loses a node, which ends as x's parent
+
+				unthread(z);
+				if (z == _header->left) // z had no left child, its successor is below its right or its parent
+					_header->left = (z->right != _nil) ? minimum(z->right) : z->parent;
+				if (z == _header->right)
+					_header->right = (z->left != _nil) ? maximum(z->left) : z->parent;
 
 				y = z; // y saves the suppressed node's placement
-				Color y_color = y->color;
+				Color y_color = y->getColor();
 				if (z->left == _nil) { // z only had 1 child whitch is the right one so so it get's replaced by it's child
 					x = z->right; // x saves the right child's branch
+					changed = z->parent;
 					rbTransplant(z, z->right);
 				} else if (z->right == _nil) {//mirror case
 					x = z->left;
+					changed = z->parent;
 					rbTransplant(z, z->left);
 				} else { // suppressed node had 2 children and is replaced by the minimum of it's right branch
 					y = minimum(z->right); // search for the minimum in the right child's branch
-					y_color = y->color;
+					y_color = y->getColor();
+					changed = (y->parent == z) ? y : y->parent;
 					x = y->right; // x saves the minimum's right branch
-					if (y->parent == z) // the minimum is z->right
-						x->parent = y;
-					else {
+					if (y->parent != z) { // the minimum is not z->right
 						rbTransplant(y, y->right); // replaces the minimum by it's right branch
 						y->right = z->right; // set the new z's right side
 						y->right->parent = y;
@@ -156,26 +477,959 @@ namespace ft
 					rbTransplant(z, y); // replace z by the correct value whitch is y and maintain the tree as a good search tree
 					y->left = z->left; // set the new z's left side
 					y->left->parent = y;
-					y->color = z->color; // we keep the old z color
+					y->setColor(z->getColor()); // we keep the old z color
 				}
-				_alloc.destroy(z);
-				_alloc.deallocate(z, 1);
+				updatePath(changed);
 				_size--;
 				if (y_color == black) // fix the lost black color on x
-					fixDelete(x);
-				return true;
+					fixDelete(x, changed);
+			}
+
+			// erase the nodes from first up to last excluded (_header for the end).
+			// A smaller range is erased node by node, following successor links.
+			// When it holds most of the tree (7/8 or more), the kept nodes are relinked
+			// into a new balanced tree and the erased ones are freed without any rebalancing
+			void eraseRange(node_ptr first, node_ptr last)	{
+				node_ptr	x = first;
+				size_type	count = 0;
+
+				if (first == _header->left && last == _header) {
+					clear_h(root());
+					return;
+				}
+				for (; x != last && count * 8 < _size * 7; x = successor(x))
+					count++;
+				if (x == last && count * 8 < _size * 7) {
+					while (first != last) {
+						x = successor(first); // nodes never move, so x stays valid
+						eraseNode(first);
+						first = x;
+					}
+					return;
+				}
+
+				node_ptr	keep = NULL;
+				node_ptr	keep_tail = NULL;
+				node_ptr	drop = NULL;
+				bool		erasing = false;
+
+				partitionNodes(root(), first, last, erasing, keep, keep_tail, drop);
+				for (x = drop; x != NULL; x = x->right)
+					_size--;
+				root() = relinkSorted(keep, _size, 0, redDepth(_size));
+				if (root() != _nil)
+					root()->parent = _header;
+				updateExtremes();
+				rethread();
+				while (drop != NULL) {
+					x = drop->right;
+					_alloc.destroy(drop);
+					_alloc.deallocate(drop, 1);
+					drop = x;
+				}
+			}
+
+			// move the nodes whose keys are not less than k into right, freeing the nodes right had.
+			// The path down to k is cut and the subtrees hanging from it are joined back into
+			// two trees, in O(log n). Sizes come from the node update metadata when it counts
+			// nodes, otherwise by walking both halves side by side until the smaller one ends.
+			// split, join, merge and reinsertNode hand nodes over as they are only between
+			// trees whose allocators compare equal, so that every node goes back to the pool it
+			// came from. Otherwise the values are copied into nodes of the receiving tree
+			// and the old nodes freed, and split runs in O(n)
+			template <class K>
+			void split(const K &k, RBTree &right)
+			{
+				node_ptr	l, r, a, b;
+				size_type	hl, hr, n;
+
+				if (&right == this)
+					return;
+				right.clear_h(right.root());
+				if (root() == _nil)
+					return;
+				if (!(_alloc == right._alloc))	{
+					a = lower_bound_node(k);
+					right.copyRange(*this, a, _header);
+					eraseRange(a, _header);
+					return;
+				}
+				splitNodes(root(), blackHeight(root()), k, l, hl, r, hr);
+				n = subtree_size(l);
+				right.setRoot(r);
+				setRoot(l);
+				right.closeThreads(); // each half is still threaded in order inside
+				closeThreads();
+				if (n == static_cast<size_type>(-1))	{
+					a = _header->left;
+					b = right._header->left;
+					for (n = 0; a != _header && b != right._header; n++)	{
+						a = successor(a);
+						b = right.successor(b);
+					}
+					if (a != _header)
+						n = _size - n;
+				}
+				right._size = _size - n;
+				_size = n;
+			}
+
+			// append the nodes of right, leaving it empty. When all its keys are greater than ours,
+			// or all less, both trees are joined in O(log n) around right's first or last node.
+			// Otherwise its nodes are merged one by one, and those whose key is already here stay in right
+			void join(RBTree &right)
+			{
+				node_ptr	x;
+				size_type	h;
+				bool		after;
+
+				if (&right == this || right._size == 0)
+					return;
+				if (_size == 0 || _comp(getKey()(_header->right->data), getKey()(right._header->left->data)))
+					after = true;
+				else if (_comp(getKey()(right._header->right->data), getKey()(_header->left->data)))
+					after = false;
+				else	{
+					merge(right);
+					return;
+				}
+				if (!(_alloc == right._alloc))	{ // every key is missing here, merge copies them all
+					merge(right);
+					return;
+				}
+				x = after ? right._header->left : right._header->right;
+				right.unlinkNode(x);
+				if (after)	{
+					threadBetween(_header->right, x, right._header->left, right._header);
+					root() = joinNodes(root(), blackHeight(root()), x, right.root(), blackHeight(right.root()), h);
+				}
+				else	{
+					threadBetween(right._header->right, x, _header->left, right._header);
+					root() = joinNodes(right.root(), blackHeight(right.root()), x, root(), blackHeight(root()), h);
+				}
+				root()->parent = _header;
+				_size += right._size + 1;
+				updateExtremes();
+				closeThreads();
+				right.root() = _nil;
+				right._size = 0;
+				right.updateExtremes();
+				right.closeThreads();
+			}
+
+			// move every node of other whose key is missing here, without allocating or copying
+			// when both allocators compare equal. Otherwise each value is copied, then erased from other
+			void merge(RBTree &other)
+			{
+				node_ptr	parent;
+				bool		left;
+				node_ptr	next;
+				bool		same_pool = (_alloc == other._alloc);
+
+				if (&other == this)
+					return;
+				for (node_ptr node = other._header->left; node != other._header; node = next)	{
+					next = other.successor(node); // nodes never move, so next stays valid
+					if (descend(getKey()(node->data), parent, left) == _nil)	{
+						if (same_pool)	{
+							other.unlinkNode(node);
+							relinkNode(parent, left, node);
+						}
+						else	{
+							linkNode(parent, left, createNode(node->data));
+							other.eraseNode(node);
+						}
+					}
+				}
+			}
+
+			// link a node unlinked from this tree or another one, allocated by from, unless its key
+			// is already present, in which case the node is left alone and the one in place is returned.
+			// A node from another pool is copied into one of ours, and freed through from
+			ft::pair<node_ptr, bool> reinsertNode(node_ptr node, const allocator_type &from)
+			{
+				node_ptr	parent;
+				bool		left;
+				node_ptr	x = descend(getKey()(node->data), parent, left);
+
+				if (x != _nil)
+					return ft::pair<node_ptr, bool>(x, false);
+				if (!(_alloc == from))	{
+					allocator_type	owner(from);
+
+					x = createNode(node->data);
+					owner.destroy(node);
+					owner.deallocate(node, 1);
+					return ft::pair<node_ptr, bool>(linkNode(parent, left, x), true);
+				}
+				return ft::pair<node_ptr, bool>(relinkNode(parent, left, node), true);
+			}
+
+			// set algebra in O(n + m): both trees are walked in order side by side, the nodes
+			// of the result are chained and relinked into a balanced tree like a sorted build.
+			// unionWith adds copies of the elements of other whose key is missing here,
+			// equivalent keys keep our element. intersectWith frees our nodes whose key is
+			// not in other. Our nodes are reused, never copied
+			void unionWith(const RBTree &other)
+			{
+				node_ptr	mine = NULL;
+				node_ptr	tail = NULL;
+				node_ptr	drop = NULL;
+				node_ptr	chain = NULL;
+				node_ptr	theirs = other._header->left;
+				size_type	n = 0;
+				bool		erasing = false;
+
+				if (this == &other || other._size == 0)
+					return;
+				partitionNodes(root(), _header, _header, erasing, mine, tail, drop); // every node is kept
+				if (tail != NULL)
+					tail->right = NULL; // still the nil leaf of the last node
+				tail = NULL;
+				try {
+					for (; theirs != other._header; n++)	{
+						if (mine != NULL && !_comp(getKey()(theirs->data), getKey()(mine->data)))	{
+							if (!_comp(getKey()(mine->data), getKey()(theirs->data)))
+								theirs = other.successor(theirs);
+							node_ptr next = mine->right;
+							appendNode(chain, tail, mine);
+							mine = next;
+						}
+						else	{
+							appendNode(chain, tail, createNode(theirs->data));
+							theirs = other.successor(theirs);
+						}
+					}
+				}
+				catch (...) { // keep what is already there
+					appendChain(chain, tail, mine, n);
+					relinkChain(chain, n);
+					throw;
+				}
+				appendChain(chain, tail, mine, n);
+				relinkChain(chain, n);
+			}
+
+			void intersectWith(const RBTree &other)
+			{
+				node_ptr	mine = NULL;
+				node_ptr	tail = NULL;
+				node_ptr	drop = NULL;
+				node_ptr	chain = NULL;
+				node_ptr	theirs = other._header->left;
+				size_type	n = 0;
+				bool		erasing = false;
+
+				if (this == &other)
+					return;
+				partitionNodes(root(), _header, _header, erasing, mine, tail, drop);
+				if (tail != NULL)
+					tail->right = NULL;
+				tail = NULL;
+				while (mine != NULL)	{
+					node_ptr next = mine->right;
+					while (theirs != other._header && _comp(getKey()(theirs->data), getKey()(mine->data)))
+						theirs = other.successor(theirs);
+					if (theirs != other._header && !_comp(getKey()(mine->data), getKey()(theirs->data)))	{
+						appendNode(chain, tail, mine);
+						n++;
+					}
+					else	{
+						mine->right = drop;
+						drop = mine;
+					}
+					mine = next;
+				}
+				relinkChain(chain, n);
+				while (drop != NULL)	{
+					node_ptr next = drop->right;
+					_alloc.destroy(drop);
+					_alloc.deallocate(drop, 1);
+					drop = next;
+				}
+			}
+
+			// order statistics, for NodeUpdate = order_statistics_node_update only.
+			// node at position k in key order, or _header when k is not below the size
+			node_ptr select(size_type k) const
+			{
+				node_ptr x = root();
+
+				while (x != _nil)	{
+					if (k < x->left->count)
+						x = x->left;
+					else if (k == x->left->count)
+						return (x);
+					else	{
+						k -= x->left->count + 1;
+						x = x->right;
+					}
+				}
+				return (_header);
+			}
+
+			// number of keys less than k
+			template <class K>
+			size_type rank(const K &k) const
+			{
+				node_ptr	x = root();
+				size_type	res = 0;
+
+				while (x != _nil)	{
+					if (_comp(getKey()(x->data), k)) { // x and its left subtree are below k
+						res += x->left->count + 1;
+						x = x->right;
+					}
+					else
+						x = x->left;
+				}
+				return (res);
 			}
 
 		private:
+			enum { batch_size = 16 }; // descents of findMany in flight, enough to cover memory latency
+
+			typename node_type::parent_link &root() const { return (_header->parent); }
+
+			// the leaf of every tree of this type, so that subtrees move between trees without
+			// relinking. A node that is its own child is how iterators spot it. It is built on first
+			// use, under the guard of function local statics, and never written afterwards, so
+			// trees used from different threads only ever read it
+# ifdef FT_INDEX_NODES
+			struct nil_holder {
+				allocator_type 	alloc; // nodes are named by their place in pages of a pool
+				node_ptr 		nil;
+
+				nil_holder(): alloc(), nil(alloc.allocate(1)) { new (static_cast<void *>(nil)) node_type(NULL, nil, nil, black); }
+				~nil_holder() { alloc.destroy(nil); alloc.deallocate(nil, 1); }
+
+				private:
+					nil_holder(const nil_holder &);
+					nil_holder &operator=(const nil_holder &);
+			};
+
+			static node_ptr sharedNil()
+			{
+				static nil_holder 	holder;
+				return (holder.nil);
+			}
+# else
+			static node_ptr sharedNil()
+			{
+				static node_type 	nil(NULL, &nil, &nil, black);
+				return (&nil);
+			}
+# endif
+
+			static void prefetch(const node_type *node)
+			{
+# if defined(__GNUC__) || defined(__clang__)
+				__builtin_prefetch(node);
+# else
+				(void)node;
+# endif
+			}
+
+			// find the node holding k, or _nil with the parent and side k belongs on
+			node_ptr descend(const key_type &k, node_ptr &parent, bool &left) const
+			{
+				node_ptr x = root();
+
+				parent = _header;
+				left = true;
+				while (x != _nil)	{
+					parent = x;
+					if (_comp(k, getKey()(x->data))) {
+						left = true;
+						x = x->left;
+					}
+					else if (_comp(getKey()(x->data), k)) {
+						left = false;
+						x = x->right;
+					}
+					else
+						return (x);
+				}
+				return (_nil);
+			}
+
+			// linkNode for a node that was in a tree: its old links are dropped first
+			node_ptr relinkNode(node_ptr parent, bool left, node_ptr node)
+			{
+				node->left = _nil;
+				node->right = _nil;
+				node->setColor(red);
+				return (linkNode(parent, left, node));
+			}
+
+			// hang a node from createNode under parent (_header for an empty tree), then rebalance
+			node_ptr linkNode(node_ptr parent, bool left, node_ptr node)
+			{
+				node->parent = parent;
+				this->_size++;
+				update(node);
+				// if new node is a root node, simply return
+				if (parent == _header)	{
+					root() = node;
+					_header->left = node;
+					_header->right = node;
+					node->setColor(black);
+					thread(node, parent, left);
+					return (node);
+				}
+				if (left)	{
+					parent->left = node;
+					if (parent == _header->left)
+						_header->left = node;
+				}
+				else	{
+					parent->right = node;
+					if (parent == _header->right)
+						_header->right = node;
+				}
+				thread(node, parent, left);
+				updatePath(parent);
+				// if the parent is the root, simply return
+				if (parent->parent == _header)
+					return (node);
+				// Fix the tree colors
+				fixInsert(node);
+				return (node);
+			}
+
+			template <class InputIterator>
+			void insert_range(InputIterator first, InputIterator last, std::input_iterator_tag) {
+				node_ptr hint = _header;
+
+				for (; first != last; ++first)
+					hint = insert_hint(hint, *first).first; // sorted input keeps hitting the hint
+			}
+
+			template <class ForwardIterator>
+			void insert_range(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+				size_type n = 0;
+
+				if (_size == 0 && first != last)	{
+					// a single pass tells whether the range is sorted and how many distinct keys it holds
+					ForwardIterator prev = first;
+					ForwardIterator it = first;
+					for (n = 1, ++it; it != last; prev = it, ++it) {
+						if (_comp(getKey()(*it), getKey()(*prev)))
+							break;
+						if (_comp(getKey()(*prev), getKey()(*it)))
+							n++;
+					}
+					if (it == last) {
+						buildSorted(first, last, n);
+						return;
+					}
+				}
+				insert_range(first, last, std::input_iterator_tag());
+			}
+
+			// build a perfectly balanced tree out of the n distinct keys of a sorted range.
+			// The nodes are all created first, chained through right, and only linked once every
+			// one of them exists: if a copy or an allocation throws, the chain is freed and the
+			// tree is left empty
+			template <class ForwardIterator>
+			void buildSorted(ForwardIterator it, ForwardIterator last, size_type n)
+			{
+				node_ptr chain = NULL;
+				node_ptr tail = NULL;
+
+				try {
+					while (it != last)	{
+						appendNode(chain, tail, createNode(*it));
+						ForwardIterator cur = it;
+						for (++it; it != last && !_comp(getKey()(*cur), getKey()(*it)); ++it) ; // skip duplicates, the first one wins
+					}
+				}
+				catch (...) {
+					freeChain(chain, tail);
+					throw;
+				}
+				relinkChain(chain, n);
+			}
+
+			// make this empty tree a copy of the nodes of other from first up to last excluded.
+			// If a copy throws, the tree is left empty
+			void copyRange(const RBTree &other, node_ptr first, node_ptr last)
+			{
+				node_ptr	chain = NULL;
+				node_ptr	tail = NULL;
+				size_type	n = 0;
+
+				try {
+					for (; first != last; first = other.successor(first), n++)
+						appendNode(chain, tail, createNode(first->data));
+				}
+				catch (...) {
+					freeChain(chain, tail);
+					throw;
+				}
+				relinkChain(chain, n);
+			}
+
+			// depth of the last, incomplete level of a perfectly balanced tree of n nodes:
+			// its nodes are red, so that every path holds as many black nodes
+			static size_type redDepth(size_type n)
+			{
+				size_type depth = 0;
+
+				while (((size_type)2 << depth) <= n + 1)
+					depth++;
+				return (depth);
+			}
+
+			// in-order walk unlinking every node: the ones from first up to last excluded
+			// are pushed on drop, the others appended to the keep chain. Both chains go through right
+			void partitionNodes(node_ptr node, node_ptr first, node_ptr last, bool &erasing, node_ptr &keep, node_ptr &keep_tail, node_ptr &drop)
+			{
+				if (node == _nil)
+					return;
+				node_ptr right = node->right;
+				partitionNodes(node->left, first, last, erasing, keep, keep_tail, drop);
+				if (node == first)
+					erasing = true;
+				if (node == last)
+					erasing = false;
+				if (erasing) {
+					node->right = drop;
+					drop = node;
+				}
+				else {
+					if (keep == NULL)
+						keep = node;
+					else
+						keep_tail->right = node;
+					keep_tail = node;
+				}
+				partitionNodes(right, first, last, erasing, keep, keep_tail, drop);
+			}
+
+			// perfectly balanced subtree out of the next n nodes of a chain. Every level above
+			// red_depth is complete, so coloring that level red keeps the black height equal
+			node_ptr relinkSorted(node_ptr &chain, size_type n, size_type depth, size_type red_depth)
+			{
+				if (n == 0)
+					return _nil;
+
+				node_ptr left = relinkSorted(chain, (n - 1) / 2, depth + 1, red_depth);
+				node_ptr node = chain;
+				chain = chain->right;
+				node->left = left;
+				if (left != _nil)
+					left->parent = node;
+				node->right = relinkSorted(chain, n - 1 - (n - 1) / 2, depth + 1, red_depth);
+				if (node->right != _nil)
+					node->right->parent = node;
+				node->setColor(depth == red_depth ? red : black);
+				update(node);
+				return node;
+			}
+
+			void updateExtremes()
+			{
+				_header->left = (root() == _nil) ? _header : minimum(root());
+				_header->right = (root() == _nil) ? _header : maximum(root());
+			}
+
+			// chains threaded through right links, relinked into a balanced tree of n nodes
+			static void appendNode(node_ptr &chain, node_ptr &tail, node_ptr node)
+			{
+				if (chain == NULL)
+					chain = node;
+				else
+					tail->right = node;
+				tail = node;
+			}
+
+			static void appendChain(node_ptr &chain, node_ptr &tail, node_ptr rest, size_type &n)
+			{
+				while (rest != NULL)	{
+					node_ptr next = rest->right;
+					appendNode(chain, tail, rest);
+					rest = next;
+					n++;
+				}
+			}
+
+			void relinkChain(node_ptr chain, size_type n)
+			{
+				root() = relinkSorted(chain, n, 0, redDepth(n));
+				_size = n;
+				setRoot(root());
+				rethread();
+			}
+
+			// make node, with a black root, the whole tree
+			void setRoot(node_ptr node)
+			{
+				root() = node;
+				if (node != _nil)
+					node->parent = _header;
+				updateExtremes();
+			}
+
+			// black nodes on every path from node down to a leaf, node included
+			size_type blackHeight(node_ptr node) const
+			{
+				size_type h = 0;
+
+				for (; node != _nil; node = node->left)
+					if (node->getColor() == black)
+						h++;
+				return (h);
+			}
+
+			// join the trees l and r, of black heights hl and hr, around x whose key sits between
+			// theirs, and return the new root, of black height h. The taller tree keeps its shape:
+			// x takes the place of the first black node of the other height down its inner spine,
+			// with the shorter tree as its other child, and is then fixed like an insertion.
+			// _header is the parent of the tree being fixed
+			node_ptr joinNodes(node_ptr l, size_type hl, node_ptr x, node_ptr r, size_type hr, size_type &h)
+			{
+				if (l->getColor() == red) { // a red root turns black, one level higher
+					l->setColor(black);
+					hl++;
+				}
+				if (r->getColor() == red) {
+					r->setColor(black);
+					hr++;
+				}
+				if (hl == hr)	{
+					x->left = l;
+					x->right = r;
+					x->parent = _header;
+					x->setColor(black);
+					if (l != _nil)
+						l->parent = x;
+					if (r != _nil)
+						r->parent = x;
+					update(x);
+					h = hl + 1;
+					return (x);
+				}
+
+				bool		right_spine = (hl > hr); // x goes down the right side of l
+				node_ptr	y = right_spine ? l : r;
+				size_type	target = right_spine ? hr : hl;
+				size_type	yh = right_spine ? hl : hr;
+
+				root() = y;
+				y->parent = _header;
+				h = yh;
+				for (; y->getColor() == red || yh != target; y = right_spine ? y->right : y->left)	{
+					if (y->getColor() == black)
+						yh--;
+					x->parent = y; // y may end on the leaf, whose parent is not kept
+				}
+				if (right_spine)	{
+					x->parent->right = x;
+					x->left = y;
+					x->right = r;
+					if (r != _nil)
+						r->parent = x;
+				}
+				else	{
+					x->parent->left = x;
+					x->left = l;
+					x->right = y;
+					if (l != _nil)
+						l->parent = x;
+				}
+				if (y != _nil)
+					y->parent = x;
+				x->setColor(red);
+				updatePath(x);
+				h += fixInsert(x);
+				return (root());
+			}
+
+			// split the subtree t, of black height ht, into the nodes with keys less than k, in l,
+			// and the others, in r, with their black heights. Every node on the way down to k
+			// joins its subtree on the far side to the matching part of the subtree below
+			template <class K>
+			void splitNodes(node_ptr t, size_type ht, const K &k, node_ptr &l, size_type &hl, node_ptr &r, size_type &hr)
+			{
+				node_ptr	part;
+				size_type	hpart;
+
+				if (t == _nil)	{
+					l = _nil;
+					r = _nil;
+					hl = 0;
+					hr = 0;
+					return;
+				}
+				node_ptr	left = t->left;
+				node_ptr	right = t->right;
+				size_type	hc = ht - (t->getColor() == black);
+
+				if (_comp(getKey()(t->data), k))	{
+					splitNodes(right, hc, k, part, hpart, r, hr);
+					l = joinNodes(left, hc, t, part, hpart, hl);
+				}
+				else	{
+					splitNodes(left, hc, k, l, hl, part, hpart);
+					r = joinNodes(part, hpart, t, right, hc, hr);
+				}
+			}
+
+			// unlink every node of the subtree into a chain threaded through right pointers
+			void detachNodes(node_ptr node, node_ptr &chain)
+			{
+				if (node == _nil)
+					return;
+				detachNodes(node->left, chain);
+				detachNodes(node->right, chain);
+				node->right = chain;
+				chain = node;
+			}
+
+			// free a chain of nodes threaded through right pointers, ended by tail or by NULL
+			void freeChain(node_ptr chain, node_ptr tail = NULL)
+			{
+				while (chain != NULL)	{
+					node_ptr next = (chain == tail) ? NULL : node_ptr(chain->right);
+					_alloc.destroy(chain);
+					_alloc.deallocate(chain, 1);
+					chain = next;
+				}
+			}
+
+			// free a subtree that is not part of the tree, leaving _size alone
+			void freeNodes(node_ptr node)
+			{
+				if (node == _nil)
+					return;
+				freeNodes(node->left);
+				freeNodes(node->right);
+				_alloc.destroy(node);
+				_alloc.deallocate(node, 1);
+			}
+
+			// copy of the subtree src. If a copy throws, the part of it already built is freed
+			node_ptr cloneHelper(node_ptr src, node_ptr src_nil, node_ptr parent, node_ptr &spare)
+			{
+				node_ptr node;
+
+				if (src == src_nil)
+					return _nil;
+				if (spare != NULL) {
+					node = spare;
+					spare = spare->right;
+					_alloc.destroy(node);
+					try {
+						new (static_cast<void *>(node)) node_type(parent, _nil, _nil, src->getColor(), src->data);
+					}
+					catch (...) {
+						_alloc.deallocate(node, 1);
+						throw;
+					}
+				}
+				else	{
+					node = createNode(src->data);
+					node->parent = parent;
+					node->setColor(src->getColor());
+				}
+				try {
+					node->left = cloneHelper(src->left, src_nil, node, spare);
+					node->right = cloneHelper(src->right, src_nil, node, spare);
+				}
+				catch (...) {
+					freeNodes(node);
+					throw;
+				}
+				update(node);
+				return node;
+			}
+
+			// compact() first gives every node its new place, kept in its parent link
+			// until the values are moved, then links the new nodes in the same shape
+			void place(node_ptr x, node_ptr &slot)
+			{
+				x->parent = slot;
+				slot = _alloc.next_in_run(slot);
+			}
+
+			void placeInOrder(node_ptr x, node_ptr &slot)
+			{
+				if (x == _nil)
+					return;
+				placeInOrder(x->left, slot);
+				place(x, slot);
+				placeInOrder(x->right, slot);
+			}
+
+			// the top half of the levels of the subtree first, then each subtree hanging below it
+			void placeVeb(node_ptr x, size_type levels, node_ptr &slot)
+			{
+				if (x == _nil)
+					return;
+				if (levels == 1)	{
+					place(x, slot);
+					return;
+				}
+				placeVeb(x, levels / 2, slot);
+				placeVebBelow(x, levels / 2, levels - levels / 2, slot);
+			}
+
+			void placeVebBelow(node_ptr x, size_type depth, size_type levels, node_ptr &slot)
+			{
+				if (x == _nil)
+					return;
+				if (depth == 0)
+					return (placeVeb(x, levels, slot));
+				placeVebBelow(x->left, depth - 1, levels, slot);
+				placeVebBelow(x->right, depth - 1, levels, slot);
+			}
+
+			size_type height(node_ptr x) const
+			{
+				if (x == _nil)
+					return (0);
+				size_type left = height(x->left);
+				size_type right = height(x->right);
+				return (1 + (left < right ? right : left));
+			}
+
+			// build the new node of every node in preorder, counting them
+			void moveValues(node_ptr x, size_type &built)
+			{
+				if (x == _nil)
+					return;
+# if __cplusplus >= 201103L
+				new (static_cast<void *>(node_ptr(x->parent))) node_type(NULL, _nil, _nil, x->getColor(), std::move_if_noexcept(x->data));
+# else
+				new (static_cast<void *>(node_ptr(x->parent))) node_type(NULL, _nil, _nil, x->getColor(), x->data);
+# endif
+				built++;
+				moveValues(x->left, built);
+				moveValues(x->right, built);
+			}
+
+			// undo moveValues for its first built nodes
+			void destroyMoved(node_ptr x, size_type &built)
+			{
+				if (x == _nil || built == 0)
+					return;
+				_alloc.destroy(node_ptr(x->parent));
+				built--;
+				destroyMoved(x->left, built);
+				destroyMoved(x->right, built);
+			}
+
+			void restoreParents(node_ptr x, node_ptr parent)
+			{
+				if (x == _nil)
+					return;
+				x->parent = parent;
+				restoreParents(x->left, x);
+				restoreParents(x->right, x);
+			}
+
+			// link the new node of x under parent and free x
+			node_ptr relinkMoved(node_ptr x, node_ptr parent)
+			{
+				node_ptr node = x->parent;
+				node_ptr left = x->left;
+				node_ptr right = x->right;
+
+				_alloc.destroy(x);
+				_alloc.deallocate(x, 1);
+				node->parent = parent;
+				if (left != _nil)
+					node->left = relinkMoved(left, node);
+				if (right != _nil)
+					node->right = relinkMoved(right, node);
+				update(node);
+				return (node);
+			}
+
+			// in-order links of FT_THREADED_NODES, which go from the header to the minimum and
+			// from the maximum back to the header. Rotations keep the order, so only linking and
+			// unlinking a node change them, and rebuilding a whole tree threads it again
+# ifdef FT_THREADED_NODES
+			// a new child comes right before its parent when on its left, right after it otherwise
+			static void thread(node_ptr node, node_ptr parent, bool left)
+			{
+				node_ptr prev = left ? node_ptr(parent->prev) : parent;
+				node_ptr next = left ? parent : node_ptr(parent->next);
+
+				node->prev = prev;
+				node->next = next;
+				prev->next = node;
+				next->prev = node;
+			}
+
+			static void unthread(node_ptr node)
+			{
+				node->prev->next = node->next;
+				node->next->prev = node->prev;
+			}
+
+			// x, about to be joined, between the end of the lower tree and the start of the higher one.
+			// Either may be empty, in which case its end is the header of that tree
+			void threadBetween(node_ptr lower, node_ptr x, node_ptr higher, node_ptr right_header)
+			{
+				if (lower != _header && lower != right_header)	{
+					lower->next = x;
+					x->prev = lower;
+				}
+				if (higher != _header && higher != right_header)	{
+					higher->prev = x;
+					x->next = higher;
+				}
+			}
+
+			// link both ends of the thread to the header, after the extremes changed
+			void closeThreads()
+			{
+				_header->next = _header->left;
+				_header->left->prev = _header;
+				_header->prev = _header->right;
+				_header->right->next = _header;
+			}
+
+			void rethread()
+			{
+				node_ptr last = _header;
+
+				rethreadHelper(root(), last);
+				last->next = _header;
+				_header->prev = last;
+			}
+
+			void rethreadHelper(node_ptr node, node_ptr &last)
+			{
+				if (node == _nil)
+					return;
+				rethreadHelper(node->left, last);
+				last->next = node;
+				node->prev = last;
+				last = node;
+				rethreadHelper(node->right, last);
+			}
+
+			node_ptr successor(node_ptr x) const { return (x->next); }
+			node_ptr predecessor(node_ptr x) const { return (x->prev); }
+# else
+			static void thread(node_ptr, node_ptr, bool) {}
+			static void unthread(node_ptr) {}
+			void threadBetween(node_ptr, node_ptr, node_ptr, node_ptr) {}
+			void closeThreads() {}
+			void rethread() {}
+
 			// find the successor of a given node
-			node_ptr successor(node_ptr x)
+			node_ptr successor(node_ptr x) const
 			{
 				// if the right subtree is not null the successor is the leftmost node in the sright subtree
 				if (x->right != _nil)
 					return minimum(x->right);
 				// else it is the lowest ancestor of x whose left child is also an ancestor of x
 				node_ptr y = x->parent;
-				while (y != NULL && x == y->right)	{
+				while (y != _header && x == y->right)	{
 					x = y;
 					y = y->parent;
 				}
@@ -183,18 +1437,19 @@ namespace ft
 			}
 
 			// find the predecessor of a given node
-			node_ptr predecessor(node_ptr x)
+			node_ptr predecessor(node_ptr x) const
 			{
 				// if the left subtree is not null the predecessor is the rightmost node in the left subtree
 				if (x->left != _nil)
 					return maximum(x->left);
 				node_ptr y = x->parent;
-				while (y != NULL && x == y->left)	{
+				while (y != _header && x == y->left)	{
 					x = y;
 					y = y->parent;
 				}
 				return y;
 			}
+# endif
 		
 			void left_rotate(node_ptr x)
 			{
@@ -204,14 +1459,16 @@ namespace ft
 				if (y->left != _nil) // if y->left isn't NULL
 					y->left->parent = x;
 				y->parent = x->parent; // y is new x so it takes old x's parent
-				if (x->parent == NULL)
-					this->_root = y;
+				if (x->parent == _header)
+					root() = y;
 				else if (x == x->parent->left) // if x was it's parent's left child, y becomes it's new parent's left child
 					x->parent->left = y;
 				else
 					x->parent->right = y; // mirror case
 				y->left = x;
 				x->parent = y;
+				update(x);
+				update(y);
 			}
 
 			void right_rotate(node_ptr x) // mirror case
@@ -222,28 +1479,31 @@ namespace ft
 				if (y->right != _nil)
 					y->right->parent = x;
 				y->parent = x->parent;
-				if (x->parent == NULL)
-					this->_root = y;
+				if (x->parent == _header)
+					root() = y;
 				else if (x == x->parent->left)
 					x->parent->left = y;
 				else
 					x->parent->right = y;
 				y->right = x;
 				x->parent = y;
+				update(x);
+				update(y);
 			}
 		
-			void fixInsert(node_ptr z)
+			// returns true when the root had turned red, which adds a black level to the tree
+			bool fixInsert(node_ptr z)
 			{
 				node_ptr u;
-				while (z->parent->color == red)	{
+				while (z->parent->getColor() == red)	{
 					if (z->parent == z->parent->parent->right) // parent is gp's right child
 					{
 						u = z->parent->parent->left; // uncle is left
-						if (u->color == red) // if uncle also red
+						if (u->getColor() == red) // if uncle also red
 						{
-							u->color = black;
-							z->parent->color = black;
-							z->parent->parent->color = red;
+							u->setColor(black);
+							z->parent->setColor(black);
+							z->parent->parent->setColor(red);
 							z = z->parent->parent;
 						}
 						else {
@@ -251,19 +1511,19 @@ namespace ft
 								z = z->parent;
 								right_rotate(z); // new z is old parent
 							}
-							z->parent->color = black;
-							z->parent->parent->color = red;
+							z->parent->setColor(black);
+							z->parent->parent->setColor(red);
 							left_rotate(z->parent->parent);
 						}
 					}
 					else // parent is gp's left child #mirror_case
 					{
 						u = z->parent->parent->right; // uncle
-						if (u->color == red) {
+						if (u->getColor() == red) {
 						// mirror case
-							u->color = black;
-							z->parent->color = black;
-							z->parent->parent->color = red;
+							u->setColor(black);
+							z->parent->setColor(black);
+							z->parent->parent->setColor(red);
 							z = z->parent->parent;
 						}
 						else	{
@@ -273,107 +1533,115 @@ namespace ft
 								left_rotate(z);
 							}
 							// mirror case
-							z->parent->color = black;
-							z->parent->parent->color = red;
+							z->parent->setColor(black);
+							z->parent->parent->setColor(red);
 							right_rotate(z->parent->parent);
 						}
 					}
-					if (z == _root)
+					if (z == root())
 						break;
 				}
-				_root->color = black; // root is black
+				bool grown = (root()->getColor() == red);
+				root()->setColor(black); // root is black
+				return (grown);
+			}
+
+			// refresh the node update metadata of node from its children
+			void update(node_ptr node) const
+			{
+				if (NodeUpdate::active)
+					_update(node, static_cast<const node_type *>(_nil));
+			}
+
+			// same for node and every ancestor, after the subtree of node changed
+			void updatePath(node_ptr node) const
+			{
+				if (!NodeUpdate::active)
+					return;
+				for (; node != _header; node = node->parent)
+					_update(node, static_cast<const node_type *>(_nil));
 			}
 
 			void rbTransplant(node_ptr u, node_ptr v) // replaces u by v
 			{
-				if (u->parent == NULL)
-					_root = v;
+				if (u->parent == _header)
+					root() = v;
 				else if (u == u->parent->left)
 					u->parent->left = v;
 				else
 					u->parent->right = v;
-				v->parent = u->parent;
+				if (v != _nil)
+					v->parent = u->parent;
 			}
 
-			// fix the rb tree modified by the delete operation
-			void fixDelete(node_ptr x)
+			// fix the rb tree modified by the delete operation. x may be the shared leaf, which is
+			// never written, so its parent is given apart and followed up the tree along with it
+			void fixDelete(node_ptr x, node_ptr parent)
 			{
 				node_ptr w;
 
-				while (x != this->_root && x->color == black)	{
-					if (x == x->parent->left) // if x is the left child
+				while (x != root() && x->getColor() == black)	{
+					if (x == parent->left) // if x is the left child
 					{
-						w = x->parent->right; // w is x's right brother
-						if (w->color == red) {
-							w->color = black;
-							x->parent->color = red;
-							left_rotate(x->parent); // new parent is w, old parent p became w's left child, p is still x's parent and x->parent->right bacame old w->left
-							w = x->parent->right;
+						w = parent->right; // w is x's right brother
+						if (w->getColor() == red) {
+							w->setColor(black);
+							parent->setColor(red);
+							left_rotate(parent); // new parent is w, old parent p became w's left child, p is still x's parent and parent->right bacame old w->left
+							w = parent->right;
 						}
-						if (w->left->color == black && w->right->color == black) {
-							w->color = red;
-							x = x->parent;
+						if (w->left->getColor() == black && w->right->getColor() == black) {
+							w->setColor(red);
+							x = parent;
+							parent = x->parent;
 						}
 						else // at least one child is red
 						{ 
-							if (w->right->color == black) // left child is red
+							if (w->right->getColor() == black) // left child is red
 							{
-								w->left->color = black;
-								w->color = red;
+								w->left->setColor(black);
+								w->setColor(red);
 								right_rotate(w);
-								w = x->parent->right;
+								w = parent->right;
 							}
-							w->color = x->parent->color;
-							x->parent->color = black;
-							w->right->color = black;
-							left_rotate(x->parent);
-							x = _root;
+							w->setColor(parent->getColor());
+							parent->setColor(black);
+							w->right->setColor(black);
+							left_rotate(parent);
+							x = root();
 						}
 					}
 					else // mirror case
 					{
-						w = x->parent->left;
-						if (w->color == red) {
-							w->color = black;
-							x->parent->color = red;
-							right_rotate(x->parent);
-							w = x->parent->left;
+						w = parent->left;
+						if (w->getColor() == red) {
+							w->setColor(black);
+							parent->setColor(red);
+							right_rotate(parent);
+							w = parent->left;
 						}
-						if (w->left->color == black && w->right->color == black) {
-							w->color = red;
-							x = x->parent;
+						if (w->left->getColor() == black && w->right->getColor() == black) {
+							w->setColor(red);
+							x = parent;
+							parent = x->parent;
 						}
 						else {
-							if (w->left->color == black) {
-								w->right->color = black;
-								w->color = red;
+							if (w->left->getColor() == black) {
+								w->right->setColor(black);
+								w->setColor(red);
 								left_rotate(w);
-								w = x->parent->left;
+								w = parent->left;
 							}
-							w->color = x->parent->color;
-							x->parent->color = black;
-							w->left->color = black;
-							right_rotate(x->parent);
-							x = _root;
+							w->setColor(parent->getColor());
+							parent->setColor(black);
+							w->left->setColor(black);
+							right_rotate(parent);
+							x = root();
 						}
 					}
 				}
-				x->color = black; // root is black
-			}
-
-			node_ptr searchTreeHelper(node_ptr node, key_type key) const
-			{
-				if (node == _nil)
-					return _nil;
-				if (key == getKey()(node->data))
-					return node;
-				if (node != _nil)
-				{
-					if (_comp(key, node->data))
-						return searchTreeHelper(node->left, key);
-					return searchTreeHelper(node->right, key);
-				}
-				return _nil;
+				if (x != _nil)
+					x->setColor(black); // root is black
 			}
 
 			void clear_helper(node_ptr const &node)
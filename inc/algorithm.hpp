@@ -15,6 +15,19 @@
 
 namespace ft 
 {
+    // operator< on any two types, the default order of the sorted range algorithms
+    struct less_than {
+        template <class T1, class T2>
+        bool operator()(const T1 &x, const T2 &y) const { return x < y; }
+    };
+
+    template <class InputIt, class OutputIt>
+    OutputIt copy(InputIt first, InputIt last, OutputIt out) {
+        for (; first != last; ++first, ++out)
+            *out = *first;
+        return out;
+    }
+
     template <class InputIterator1, class InputIterator2>
     bool equal ( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2 ) {
         for (; first1 != last1; ++first1, ++first2) {
@@ -56,6 +69,123 @@ namespace ft
         return (first1 == last1) && (first2 != last2);
     }
 
+    // set operations on sorted ranges: one pass over both, equivalent elements come from the first range.
+    // without a Compare, elements are compared with operator<
+    template<class InputIt1, class InputIt2, class OutputIt, class Compare>
+    OutputIt set_union(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out, Compare comp) {
+        for (; first1 != last1; ++out) {
+            if (first2 == last2)
+                return ft::copy(first1, last1, out);
+            if (comp(*first2, *first1)) {
+                *out = *first2;
+                ++first2;
+            }
+            else {
+                if (!comp(*first1, *first2))
+                    ++first2;
+                *out = *first1;
+                ++first1;
+            }
+        }
+        return ft::copy(first2, last2, out);
+    }
+
+    template<class InputIt1, class InputIt2, class OutputIt>
+    OutputIt set_union(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out) {
+        return ft::set_union(first1, last1, first2, last2, out, less_than());
+    }
+
+    template<class InputIt1, class InputIt2, class OutputIt, class Compare>
+    OutputIt set_intersection(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out, Compare comp) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2))
+                ++first1;
+            else {
+                if (!comp(*first2, *first1)) {
+                    *out = *first1;
+                    ++out;
+                    ++first1;
+                }
+                ++first2;
+            }
+        }
+        return out;
+    }
+
+    template<class InputIt1, class InputIt2, class OutputIt>
+    OutputIt set_intersection(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out) {
+        return ft::set_intersection(first1, last1, first2, last2, out, less_than());
+    }
+
+    template<class InputIt1, class InputIt2, class OutputIt, class Compare>
+    OutputIt set_difference(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out, Compare comp) {
+        while (first1 != last1) {
+            if (first2 == last2)
+                return ft::copy(first1, last1, out);
+            if (comp(*first1, *first2)) {
+                *out = *first1;
+                ++out;
+                ++first1;
+            }
+            else {
+                if (!comp(*first2, *first1))
+                    ++first1;
+                ++first2;
+            }
+        }
+        return out;
+    }
+
+    template<class InputIt1, class InputIt2, class OutputIt>
+    OutputIt set_difference(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out) {
+        return ft::set_difference(first1, last1, first2, last2, out, less_than());
+    }
+
+    template<class InputIt1, class InputIt2, class OutputIt, class Compare>
+    OutputIt set_symmetric_difference(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out, Compare comp) {
+        while (first1 != last1) {
+            if (first2 == last2)
+                return ft::copy(first1, last1, out);
+            if (comp(*first1, *first2)) {
+                *out = *first1;
+                ++out;
+                ++first1;
+            }
+            else {
+                if (comp(*first2, *first1)) {
+                    *out = *first2;
+                    ++out;
+                }
+                else
+                    ++first1;
+                ++first2;
+            }
+        }
+        return ft::copy(first2, last2, out);
+    }
+
+    template<class InputIt1, class InputIt2, class OutputIt>
+    OutputIt set_symmetric_difference(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out) {
+        return ft::set_symmetric_difference(first1, last1, first2, last2, out, less_than());
+    }
+
+    // whether every element of [first2, last2) is in [first1, last1)
+    template<class InputIt1, class InputIt2, class Compare>
+    bool includes(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, Compare comp) {
+        for (; first2 != last2; ++first1) {
+            if (first1 == last1 || comp(*first2, *first1))
+                return false;
+            if (!comp(*first1, *first2))
+                ++first2;
+        }
+        return true;
+    }
+
+    template<class InputIt1, class InputIt2>
+    bool includes(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2) {
+        return ft::includes(first1, last1, first2, last2, less_than());
+    }
+
 }
 
 #endif
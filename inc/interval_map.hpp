@@ -0,0 +1,274 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   interval_map.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: chduong <chduong@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/03/04 16:40:21 by chduong           #+#    #+#             */
+/*   Updated: 2023/03/04 16:40:21 by chduong          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef INTERVAL_MAP_HPP
+# define INTERVAL_MAP_HPP
+# include <memory>
+# include "iterator.hpp"
+# include "RBTree.hpp"
+# include "node_pool.hpp"
+
+namespace ft
+{
+	// node update of interval_map: every node holds the highest end of the intervals in its subtree
+	template <class Bound, class Compare>
+	class interval_node_update {
+		public:
+			struct metadata {
+				Bound 		max_high;
+
+				metadata() : max_high() {}
+			};
+
+			enum { active = true };
+
+			explicit interval_node_update(const Compare &comp = Compare()) : _comp(comp) {}
+
+			template <class Node>
+			void operator()(Node *node, const Node *nil) const	{
+				const Bound *high = &node->data.first.second;
+
+				if (node->left != nil && _comp(*high, node->left->max_high))
+					high = &node->left->max_high;
+				if (node->right != nil && _comp(*high, node->right->max_high))
+					high = &node->right->max_high;
+				node->max_high = *high;
+			}
+
+		private:
+			Compare 		_comp;
+	};
+
+	// Map keyed by half open intervals [first, second) of Bound, ordered by first then second.
+	// On top of the usual lookups by exact interval, it finds the intervals overlapping
+	// a query interval: every node knows the highest end below it, so the subtrees
+	// that cannot overlap the query are never visited.
+	template < class Bound, class T, class Compare = std::less<Bound>, class Alloc = std::allocator<ft::pair<const ft::pair<Bound, Bound>, T> > >
+	class interval_map {
+		public:
+			typedef Bound 																			bound_type;
+			typedef ft::pair<bound_type, bound_type> 												key_type;
+			typedef T 																				mapped_type;
+			typedef ft::pair<const key_type, mapped_type> 											value_type;
+			typedef Compare 																		bound_compare;
+			typedef Alloc 																			allocator_type;
+			typedef typename allocator_type::reference 												reference;
+			typedef typename allocator_type::const_reference 										const_reference;
+			typedef typename allocator_type::pointer 												pointer;
+			typedef typename allocator_type::const_pointer 											const_pointer;
+			typedef typename allocator_type::difference_type 										difference_type;
+			typedef typename allocator_type::size_type 												size_type;
+
+			// intervals by lower bound, then by upper bound
+			// the adaptable typedefs are spelled out, std::binary_function is deprecated in C++11
+			class key_compare {
+				protected:
+					Compare						comp;
+
+				public:
+					typedef key_type			first_argument_type;
+					typedef key_type			second_argument_type;
+					typedef bool				result_type;
+
+					explicit key_compare(const Compare &c = Compare()) : comp(c) {}
+
+					bool			operator()(const key_type& x, const key_type& y) const	{return comp(x.first, y.first) || (!comp(y.first, x.first) && comp(x.second, y.second));}
+			};
+
+		private:
+			struct get_key {
+				typedef value_type	argument_type;
+				typedef key_type	result_type;
+
+				const key_type &operator()(const value_type &x) const {return (x.first);}
+			};
+
+			typedef interval_node_update<bound_type, bound_compare> 								node_update;
+			typedef ft::node_pool<RBNode<value_type, node_update>, allocator_type> 				node_allocator;
+			typedef RBTree<key_type, value_type, get_key, key_compare, node_allocator, node_update> 	tree_type;
+			typedef typename tree_type::node_type 													node_type;
+			typedef typename tree_type::node_ptr 													node_ptr;
+
+		public:
+			typedef ft::tree_iterator<value_type, node_type> 										iterator;
+			typedef ft::tree_iterator<value_type const, node_type const> 							const_iterator;
+			typedef ft::tree_reverse_iterator<value_type, node_type> 								reverse_iterator;
+			typedef ft::tree_reverse_iterator<value_type const, node_type const> 					const_reverse_iterator;
+
+		private:
+			bound_compare			_comp;
+			allocator_type			_alloc;
+			tree_type				_tree;
+
+		public:
+			explicit interval_map(const bound_compare &comp = bound_compare(), const allocator_type &alloc = allocator_type())
+			: _comp(comp), _alloc(alloc), _tree(key_compare(comp), node_allocator(_alloc), node_update(comp)) {}
+
+			template <class InputIterator>
+			interval_map(InputIterator first, InputIterator last, const bound_compare& comp = bound_compare(), const allocator_type& alloc = allocator_type())
+			: _comp(comp), _alloc(alloc), _tree(key_compare(comp), node_allocator(_alloc), node_update(comp)) { insert(first, last); }
+
+			interval_map(const interval_map &x): _comp(x._comp), _alloc(x._alloc), _tree(key_compare(x._comp), node_allocator(_alloc), node_update(x._comp)) {_tree.clone(x._tree);}
+
+			~interval_map() {}
+
+			interval_map &operator=(const interval_map &x) {
+				if (this == &x)
+					return (*this);
+				this->_comp = x._comp;
+				this->_alloc = x._alloc;
+				_tree.clone(x._tree);
+				return *this;
+			}
+
+			iterator					begin() { return iterator(_tree.getHeader()->left);}
+			const_iterator				begin() const { return const_iterator(_tree.getHeader()->left);}
+			iterator					end() { return iterator(_tree.getHeader());}
+			const_iterator				end() const { return const_iterator(_tree.getHeader());}
+			reverse_iterator			rbegin() { return reverse_iterator(_tree.getHeader()->right);}
+			const_reverse_iterator		rbegin() const { return const_reverse_iterator(_tree.getHeader()->right);}
+			reverse_iterator			rend() { return reverse_iterator(_tree.getHeader());}
+			const_reverse_iterator		rend() const { return const_reverse_iterator(_tree.getHeader());}
+
+			bool						empty() const { return (_tree.getSize() == 0);}
+			size_type					size() const { return (_tree.getSize());}
+			size_type					max_size() const { return (_tree.max_size());}
+
+			void 						swap (interval_map &x) {_tree.swap(x._tree); std::swap(_comp, x._comp); std::swap(_alloc, x._alloc);}
+			void 						clear() {_tree.clear_h(_tree.getRoot());}
+
+			bound_compare 				bound_comp() const { return (this->_comp); }
+			key_compare 				key_comp() const { return (key_compare(this->_comp)); }
+			allocator_type				get_allocator() const { return (_alloc); }
+
+			mapped_type &operator[](const key_type &k) { return (_tree.emplace_key(k, default_second_t(), k).first->data.second); }
+
+			ft::pair<iterator,bool> insert(const value_type &val)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.insert_unique(val);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+			iterator insert(iterator position, const value_type &val) {
+				return iterator(_tree.insert_hint(position.base(), val).first);
+			}
+
+			template <class InputIterator>
+			void insert(InputIterator first, InputIterator last) {
+				_tree.insert_range(first, last);
+			}
+
+			void erase(iterator position) { _tree.eraseNode(position.base()); }
+
+			size_type erase(const key_type &k)	{ return (_tree.deleteNode(k) == true) ? 1 : 0;	}
+
+			void erase(iterator first, iterator last)	{ _tree.eraseRange(first.base(), last.base()); }
+
+			iterator find(const key_type &k)	{
+				node_ptr tmp = _tree.searchTree(k);
+				if (tmp == _tree.getNil())
+					return (end());
+				return iterator(tmp);
+			}
+
+			const_iterator find(const key_type &k) const {
+				node_ptr tmp = _tree.searchTree(k);
+				if (tmp == _tree.getNil())
+					return (end());
+				return const_iterator(tmp);
+			}
+
+			size_type count(const key_type& k) const	{ return (_tree.searchTree(k) == _tree.getNil() ? 0 : 1); }
+
+			iterator 				lower_bound(const key_type &k) { return iterator(_tree.lower_bound_node(k)); }
+			const_iterator 			lower_bound(const key_type &k) const { return const_iterator(_tree.lower_bound_node(k)); }
+			iterator 				upper_bound(const key_type &k) { return iterator(_tree.upper_bound_node(k)); }
+			const_iterator 			upper_bound(const key_type &k) const { return const_iterator(_tree.upper_bound_node(k)); }
+
+			// first interval, in key order, overlapping [low, high), or end(). O(log n)
+			iterator 				find_overlap(const bound_type &low, const bound_type &high) { return iterator(firstOverlap(low, high)); }
+			const_iterator 			find_overlap(const bound_type &low, const bound_type &high) const { return const_iterator(firstOverlap(low, high)); }
+
+			bool 					overlaps(const bound_type &low, const bound_type &high) const { return (firstOverlap(low, high) != _tree.getHeader()); }
+
+			// write an iterator to every interval overlapping [low, high) to out, in key order.
+			// only the paths down to the k matching intervals are visited: O(k log n) at worst,
+			// about log n + k when the matches sit next to each other
+			template <class OutputIterator>
+			OutputIterator overlapping(const bound_type &low, const bound_type &high, OutputIterator out) {
+				return (collectOverlaps<iterator>(_tree.getRoot(), low, high, out));
+			}
+
+			template <class OutputIterator>
+			OutputIterator overlapping(const bound_type &low, const bound_type &high, OutputIterator out) const {
+				return (collectOverlaps<const_iterator>(_tree.getRoot(), low, high, out));
+			}
+
+			size_type count_overlaps(const bound_type &low, const bound_type &high) const {
+				size_type n = 0;
+				countOverlaps(_tree.getRoot(), low, high, n);
+				return (n);
+			}
+
+		private:
+			bool intersects(node_ptr x, const bound_type &low, const bound_type &high) const {
+				return (_comp(x->data.first.first, high) && _comp(low, x->data.first.second));
+			}
+
+			// when the left subtree reaches past low but holds no overlap, its interval ending
+			// the highest starts at or after high, and so does everything that follows it
+			node_ptr firstOverlap(const bound_type &low, const bound_type &high) const {
+				node_ptr x = _tree.getRoot();
+				node_ptr nil = _tree.getNil();
+
+				while (x != nil)	{
+					if (x->left != nil && _comp(low, x->left->max_high))
+						x = x->left;
+					else if (intersects(x, low, high))
+						return (x);
+					else if (_comp(x->data.first.first, high))
+						x = x->right;
+					else
+						break;
+				}
+				return (_tree.getHeader());
+			}
+
+			template <class Iterator, class OutputIterator>
+			OutputIterator collectOverlaps(node_ptr x, const bound_type &low, const bound_type &high, OutputIterator out) const {
+				if (x == _tree.getNil() || !_comp(low, x->max_high))
+					return (out);
+				out = collectOverlaps<Iterator>(x->left, low, high, out);
+				if (!_comp(x->data.first.first, high)) // x and its right subtree start too late
+					return (out);
+				if (_comp(low, x->data.first.second))
+					*out++ = Iterator(x);
+				return (collectOverlaps<Iterator>(x->right, low, high, out));
+			}
+
+			void countOverlaps(node_ptr x, const bound_type &low, const bound_type &high, size_type &n) const {
+				if (x == _tree.getNil() || !_comp(low, x->max_high))
+					return;
+				countOverlaps(x->left, low, high, n);
+				if (!_comp(x->data.first.first, high))
+					return;
+				if (_comp(low, x->data.first.second))
+					n++;
+				countOverlaps(x->right, low, high, n);
+			}
+	};
+
+	template <class Bound, class T, class Compare, class Alloc>
+	void swap(interval_map<Bound, T, Compare, Alloc> &x, interval_map<Bound, T, Compare, Alloc> &y) { x.swap(y); }
+}
+
+#endif
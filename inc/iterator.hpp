@@ -170,40 +170,26 @@ namespace ft
 
 		protected:
 			node_ptr 																				_ptr;
-			node_ptr 																				_root;
-			node_ptr 																				_nil;
 		
 		public:
-			tree_iterator() 											: _ptr(NULL), _root(NULL), _nil(NULL) {}
-			tree_iterator(node_ptr ptr, node_ptr root, node_ptr nil) 	: _ptr(ptr), _root(root), _nil(nil) {}
-			tree_iterator(tree_iterator const &lhs) 					: _ptr(lhs._ptr), _root(lhs._root), _nil(lhs._nil) {}
-			virtual ~tree_iterator() {}
-			
-			tree_iterator 		&operator=(tree_iterator const &lhs)	{
-				if (this == &lhs)
-					return (*this);
-				this->_ptr = lhs._ptr;
-				this->_root = lhs._root;
-				this->_nil = lhs._nil;
-				return (*this);
-			}
+			// a single node pointer, no virtual destructor: iterators copy like a raw pointer.
+			// end() is the tree header, whose parent is the root and whose right is the maximum
+			tree_iterator() 											: _ptr(NULL) {}
+			explicit tree_iterator(node_ptr ptr) 						: _ptr(ptr) {}
 
+			node_ptr			base() const {return (_ptr);}
 			reference 			operator*() {return (_ptr->data);}
 			const_reference 	operator*() const {return (_ptr->data);}
 			pointer 			operator->() {return (&(operator*()));}
 			const_pointer 		operator->() const {return (&(operator*()));}
 
 			tree_iterator &operator++()	{
-				if (_ptr != _nil)
-					_ptr = nextNode(_ptr);
+				_ptr = nextNode(_ptr);
 				return (*this);
 			}
 
 			tree_iterator &operator--()	{
-				if (_ptr == _nil)
-					_ptr = maxNode(_root);
-				else
-					_ptr = prevNode(_ptr);
+				_ptr = prevNode(_ptr);
 				return (*this);
 			}
 
@@ -215,53 +201,156 @@ namespace ft
 			
 			// Overload called when trying to copy construct a const_iterator
 			// based on an iterator
-			operator tree_iterator<value_type const, node_type const>() const {return tree_iterator<value_type const, node_type const>(_ptr, _root, _nil);}
+			operator tree_iterator<value_type const, node_type const>() const {return tree_iterator<value_type const, node_type const>(_ptr);}
+
+# ifdef FT_ORDER_STATISTICS
+			// position of the element in key order, the size of the tree for end(), in O(log n)
+			// from the subtree counts along the path to the root
+			difference_type		index() const	{
+				if (isHeader(_ptr))
+					return (_ptr->parent->count);
+
+				node_ptr 		node = _ptr;
+				difference_type idx = node->left->count;
+
+				for (; !isHeader(node->parent); node = node->parent)
+					if (node == node->parent->right)
+						idx += node->parent->left->count + 1;
+				return (idx);
+			}
+# endif
 		
 		protected:
-		// find the node with the minimum key
-			node_ptr minNode(node_ptr node)	{
-				while (node->left != _nil)
+			template <class, class> friend class tree_reverse_iterator;
+
+			// the sentinel leaf is the only node that is its own child
+			static bool isNil(node_ptr node) {return (node->left == node);}
+
+			// the header is red and is the parent of its own parent, the root, which is black
+			static bool isHeader(node_ptr node) {return (node->getColor() == red && node->parent->parent == node);}
+
+			// find the node with the minimum key
+			static node_ptr minNode(node_ptr node)	{
+				while (!isNil(node->left))
 					node = node->left;
 				return node;
 			}
 
 			// find the node with the maximum key
-			node_ptr maxNode(node_ptr node)	{
-				while (node->right != _nil)
+			static node_ptr maxNode(node_ptr node)	{
+				while (!isNil(node->right))
 					node = node->right;
 				return node;
 			}
 
-			// find the nextNode of a given node
-			node_ptr nextNode(node_ptr node)	{
+# ifdef FT_THREADED_NODES
+			// the tree keeps every node linked to its neighbours in key order
+			static node_ptr nextNode(node_ptr node)	{return (node->next);}
+			static node_ptr prevNode(node_ptr node)	{return (node->prev);}
+# else
+			// find the nextNode of a given node, the header after the maximum
+			static node_ptr nextNode(node_ptr node)	{
 				// if the right subtree is not null the nextNode is the leftmost node in the sright subtree
-				if (node->right != _nil)
+				if (!isNil(node->right))
 					return minNode(node->right);
 				// else it is the lowest ancestor of node whose left child is also an ancestor of node
 				node_ptr parent = node->parent;
-				while (parent != NULL && node == parent->right)	{
+				while (node == parent->right)	{
 					node = parent;
 					parent = parent->parent;
 				}
-				if (parent == NULL)
-					return _nil;
-				return parent;
+				// climbing from the maximum ends on the header, unless the root is the maximum
+				if (node->right != parent)
+					node = parent;
+				return node;
 			}
 
-			// find the prevNode of a given node
-			node_ptr prevNode(node_ptr node)	{
+			// find the prevNode of a given node, the maximum before the header
+			static node_ptr prevNode(node_ptr node)	{
+				if (isHeader(node))
+					return node->right;
 				// if the left subtree is not null the prevNode is the rightmost node in the left subtree
-				if (node->left != _nil)
+				if (!isNil(node->left))
 					return maxNode(node->left);
 				node_ptr parent = node->parent;
-				while (parent != NULL && node == parent->left)	{
+				while (node == parent->left)	{
 					node = parent;
 					parent = parent->parent;
 				}
-				return parent;
+				// climbing from the minimum goes past the header when the root is the minimum
+				return (isHeader(node) ? node : parent);
+			}
+# endif
+	};
+
+	// reverse iterator of the tree containers. Unlike ft::reverse_iterator, which holds the
+	// iterator following the element and steps back on every dereference, it holds the node of
+	// the element itself: dereferencing is a load, stepping is one prevNode. rend() is the header.
+	// base() is still the iterator following the element, as with std::reverse_iterator
+	template <class T, class N>
+	class tree_reverse_iterator {
+		public:
+			typedef tree_iterator<T, N> 										iterator_type;
+			typedef typename iterator_type::iterator_category 					iterator_category;
+			typedef typename iterator_type::value_type 							value_type;
+			typedef typename iterator_type::difference_type 					difference_type;
+			typedef typename iterator_type::pointer 							pointer;
+			typedef typename iterator_type::reference 							reference;
+			typedef typename iterator_type::node_ptr 							node_ptr;
+
+		protected:
+			template <class, class> friend class tree_reverse_iterator;
+
+			node_ptr 															_ptr;
+
+		public:
+			tree_reverse_iterator() 											: _ptr(NULL) {}
+			explicit tree_reverse_iterator(node_ptr node) 						: _ptr(node) {} // the element at node, the header for rend()
+			explicit tree_reverse_iterator(const iterator_type &it) 			: _ptr(prevNode(it.base())) {}
+			template <class U, class M>
+			tree_reverse_iterator(const tree_reverse_iterator<U, M> &src) 		: _ptr(src._ptr) {}
+
+			iterator_type 			base() const {return (iterator_type(nextNode(_ptr)));}
+			reference 				operator*() const {return (_ptr->data);}
+			pointer 				operator->() const {return (&_ptr->data);}
+
+			tree_reverse_iterator 	&operator++() {_ptr = iterator_type::prevNode(_ptr); return (*this);}
+			tree_reverse_iterator 	&operator--() {_ptr = nextNode(_ptr); return (*this);}
+			tree_reverse_iterator 	operator++(int) {tree_reverse_iterator tmp(*this); operator++(); return (tmp);}
+			tree_reverse_iterator 	operator--(int) {tree_reverse_iterator tmp(*this); operator--(); return (tmp);}
+
+			template <class U, class M>
+			bool 					operator==(const tree_reverse_iterator<U, M> &rhs) const {return (_ptr == rhs._ptr);}
+			template <class U, class M>
+			bool 					operator!=(const tree_reverse_iterator<U, M> &rhs) const {return (_ptr != rhs._ptr);}
+
+		private:
+			// the header is followed by the minimum here, going from rend() back to the last element.
+			// The header of an empty tree is its own child, like the leaf, and its own neighbour
+			static node_ptr nextNode(node_ptr node)	{
+# ifndef FT_THREADED_NODES
+				if (iterator_type::isNil(node) || iterator_type::isHeader(node))
+					return (node->left);
+# endif
+				return (iterator_type::nextNode(node));
+			}
+
+			static node_ptr prevNode(node_ptr node)	{
+# ifndef FT_THREADED_NODES
+				if (iterator_type::isNil(node))
+					return (node);
+# endif
+				return (iterator_type::prevNode(node));
 			}
 	};
 
+# ifdef FT_ORDER_STATISTICS
+	// distance between tree iterators in O(log n). Only tree iterators get an ft::distance,
+	// so that an unqualified call on other iterators still finds std::distance alone
+	template <class T, class N>
+	typename tree_iterator<T, N>::difference_type distance(tree_iterator<T, N> first, tree_iterator<T, N> last)	{return (first == last ? 0 : last.index() - first.index());}
+# endif
+
 } // namespace ft
 
 #endif
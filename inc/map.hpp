@@ -15,6 +15,8 @@
 # include <memory>
 # include "iterator.hpp"
 # include "RBTree.hpp"
+# include "node_pool.hpp"
+# include "node_handle.hpp"
 
 namespace ft
 {
@@ -44,6 +46,10 @@ namespace ft
 					bool			operator()(const value_type& x, const key_type& y) const 	{return comp(x.first, y);}
 					bool			operator()(const key_type& x, const value_type& y) const 	{return comp(x, y.first);}
 					bool			operator()(const key_type& x, const key_type& y) const		{return comp(x, y);}
+
+					// keys of other types, for a transparent Compare only
+					template <class K1, class K2>
+					typename ft::enable_if_transparent<Compare, K1, bool>::type	operator()(const K1& x, const K2& y) const	{return comp(x, y);}
 			};
 		
 		private:
@@ -52,15 +58,18 @@ namespace ft
 				const _Key &operator()(const _T &x) const {return (x.first);}
 			};
 
-			typedef RBTree<key_type, value_type, get_key<value_type, key_type>, value_compare> 		tree_type;
-			typedef typename tree_type::node_type 													node_type;
+			typedef ft::node_pool<RBNode<value_type>, allocator_type> 								node_allocator;
+			typedef RBTree<key_type, value_type, get_key<value_type, key_type>, value_compare, node_allocator> 	tree_type;
+			typedef typename tree_type::node_type 													tree_node;
 			typedef typename tree_type::node_ptr 													node_ptr;
 		
 		public:
-			typedef ft::tree_iterator<value_type, node_type> 										iterator;
-			typedef ft::tree_iterator<value_type const, node_type const> 							const_iterator;
-			typedef ft::reverse_iterator<iterator> 													reverse_iterator;
-			typedef ft::reverse_iterator<const_iterator> 											const_reverse_iterator;
+			typedef ft::tree_iterator<value_type, tree_node> 										iterator;
+			typedef ft::tree_iterator<value_type const, tree_node const> 							const_iterator;
+			typedef ft::tree_reverse_iterator<value_type, tree_node> 								reverse_iterator;
+			typedef ft::tree_reverse_iterator<value_type const, tree_node const> 					const_reverse_iterator;
+			typedef ft::map_node_handle<key_type, mapped_type, tree_node, node_allocator> 			node_type;
+			typedef ft::node_insert_return<iterator, node_type> 									insert_return_type;
 
 		private:
 			key_compare				_comp;
@@ -68,168 +77,281 @@ namespace ft
 			tree_type				_tree;
 		
 		public:
-			explicit map(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()): _comp(comp), _alloc(alloc), _tree(value_comp()) {}
+			explicit map(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()): _comp(comp), _alloc(alloc), _tree(value_comp(), node_allocator(_alloc)) {}
 			
 			template <class InputIterator>
 			map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
-			: _comp(comp), _alloc(alloc), _tree(value_comp()) { insert(first, last); }
+			: _comp(comp), _alloc(alloc), _tree(value_comp(), node_allocator(_alloc)) { insert(first, last); }
 			
-			map(const map &x): _comp(x._comp), _alloc(x._alloc), _tree(value_comp()) {insert(x.begin(), x.end());}
+			map(const map &x): _comp(x._comp), _alloc(x._alloc), _tree(value_comp(), node_allocator(_alloc)) {_tree.clone(x._tree);}
 			
 			~map() {}
 
 			map &operator=(const map &x) {
 				if (this == &x)
 					return (*this);
-				if (_tree.getRoot() != _tree.getNil())
-					clear();
 				this->_comp = x._comp;
 				this->_alloc = x._alloc;
-				insert(x.begin(), x.end());
+				_tree.clone(x._tree);
 				return *this;
 			}
 
-			iterator					begin() { return iterator(_tree.minimum(_tree.getRoot()), _tree.getRoot(), _tree.getNil());}
-			const_iterator				begin() const { return const_iterator(_tree.minimum(_tree.getRoot()), _tree.getRoot(), _tree.getNil());}
-			iterator					end() { return iterator(_tree.getNil(), _tree.getRoot(), _tree.getNil());}
-			const_iterator				end() const { return const_iterator(_tree.getNil(), _tree.getRoot(), _tree.getNil());}
-			reverse_iterator			rbegin() { return reverse_iterator(end());}
-			const_reverse_iterator		rbegin() const { return const_reverse_iterator(end());}
-			reverse_iterator			rend() { return reverse_iterator(begin());}
-			const_reverse_iterator		rend() const { return const_reverse_iterator(begin());}
+			iterator					begin() { return iterator(_tree.getHeader()->left);}
+			const_iterator				begin() const { return const_iterator(_tree.getHeader()->left);}
+			iterator					end() { return iterator(_tree.getHeader());}
+			const_iterator				end() const { return const_iterator(_tree.getHeader());}
+			reverse_iterator			rbegin() { return reverse_iterator(_tree.getHeader()->right);}
+			const_reverse_iterator		rbegin() const { return const_reverse_iterator(_tree.getHeader()->right);}
+			reverse_iterator			rend() { return reverse_iterator(_tree.getHeader());}
+			const_reverse_iterator		rend() const { return const_reverse_iterator(_tree.getHeader());}
 			
 			bool						empty() const { return (_tree.getSize() == 0);}
 			size_type					size() const { return (_tree.getSize());}
 			size_type					max_size() const { return (_tree.max_size());}
 			
-			void 						swap (map &x) {_tree.swap(x._tree);}
+			void 						swap (map &x) {_tree.swap(x._tree); std::swap(_comp, x._comp); std::swap(_alloc, x._alloc);}
 			void 						clear() {_tree.clear_h(_tree.getRoot());}
+
+			// move every element into one block, in key order or in van Emde Boas order, so that
+			// scans or lookups touch fewer cache lines and pages. Invalidates every iterator
+			void 						compact(NodeLayout layout = in_order_layout) {_tree.compact(layout);}
 			
 			key_compare 				key_comp() const { return (this->_comp); }
 			value_compare 				value_comp() const { return (value_compare(this->_comp));}
 			allocator_type				get_allocator() const { return (_alloc); }
 
-			mapped_type &operator[](const key_type &k)
+			mapped_type &operator[](const key_type &k) { return (_tree.emplace_key(k, default_second_t(), k).first->data.second); }
+
+			ft::pair<iterator,bool> insert(const value_type &val)
 			{
-				node_ptr val = _tree.searchTree(k);
-
-				if (val != _tree.getNil())
-					return (val->data.second);
-				else {
-					_tree.insertNode(value_type(k, mapped_type())); // insert returns a pair an first element of pair is an it
-					val = _tree.searchTree(k);
-					return (val->data.second);
-				}
+				ft::pair<node_ptr, bool> ret = _tree.insert_unique(val);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
 			}
 
-			ft::pair<iterator,bool> insert(const value_type &val)
+			// emplace builds the element from its arguments right in the new node,
+			// try_emplace and insert_or_assign do not build anything for a key already present
+			ft::pair<iterator,bool> try_emplace(const key_type &k)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_key(k, default_second_t(), k);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+# if __cplusplus >= 201103L
+			template <class... Args>
+			ft::pair<iterator,bool> emplace(Args&&... args)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_unique(std::forward<Args>(args)...);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+			template <class A1>
+			ft::pair<iterator,bool> try_emplace(const key_type &k, A1&& a1)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_key(k, k, std::forward<A1>(a1));
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+			// pair cannot build second from several arguments: it is moved from a temporary
+			template <class A1, class A2, class... Args>
+			ft::pair<iterator,bool> try_emplace(const key_type &k, A1&& a1, A2&& a2, Args&&... args)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_key(k, k, mapped_type(std::forward<A1>(a1), std::forward<A2>(a2), std::forward<Args>(args)...));
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+			template <class M>
+			ft::pair<iterator,bool> insert_or_assign(const key_type &k, M&& obj)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_key(k, k, std::forward<M>(obj));
+				if (!ret.second)
+					ret.first->data.second = std::forward<M>(obj); // untouched by emplace_key when the key exists
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+# else
+			template <class A1>
+			ft::pair<iterator,bool> emplace(const A1 &a1)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_unique(a1);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+			template <class A1, class A2>
+			ft::pair<iterator,bool> emplace(const A1 &a1, const A2 &a2)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_unique(a1, a2);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+			template <class A1>
+			ft::pair<iterator,bool> try_emplace(const key_type &k, const A1 &a1)
+			{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_key(k, k, a1);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+			template <class M>
+			ft::pair<iterator,bool> insert_or_assign(const key_type &k, const M &obj)
 			{
-				iterator it = find(val.first);
-				if (it != end())
-					return (ft::pair<iterator,bool>(it, false));
-				else {
-					_tree.insertNode(val);
-					it = find(val.first);
-					return (ft::pair<iterator,bool>(it, true));
-				}
+				ft::pair<node_ptr, bool> ret = _tree.emplace_key(k, k, obj);
+				if (!ret.second)
+					ret.first->data.second = obj;
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
 			}
+# endif
 
-			iterator insert(iterator position, const value_type &val) { (void)position; return (insert(val).first); }
+			iterator insert(iterator position, const value_type &val) {
+				return iterator(_tree.insert_hint(position.base(), val).first);
+			}
 
 			template <class InputIterator>
 			void insert(InputIterator first, InputIterator last) {
-				while (first != last)
-					insert(*first++); // first here is a tree_iterator which has an * overload so *first = first._ptr->_data which is a pair in map so a value_type
+				_tree.insert_range(first, last);
 			}
 
-			void erase(iterator position) { erase((*position).first); }
+			// link the node of nh, unless its key is already here: nh then gets it back in the result
+			insert_return_type insert(node_type nh) {
+				if (nh.empty())
+					return (insert_return_type(end(), false, nh));
+				ft::pair<node_ptr, bool> ret = _tree.reinsertNode(nh.get(), nh.get_allocator());
+				if (ret.second)
+					nh.release();
+				return (insert_return_type(iterator(ret.first), ret.second, nh));
+			}
 
-			size_type erase(const key_type &k)	{ return (_tree.deleteNode(k) == true) ? 1 : 0;	}
+			void erase(iterator position) { _tree.eraseNode(position.base()); }
 
-			void erase(iterator first, iterator last)	{
-				while(first != last)
-					erase((*(first++)).first);
+			// unlink an element and hand its node over, neither destroyed nor copied
+			node_type extract(iterator position) {
+				_tree.unlinkNode(position.base());
+				return (node_type(position.base(), _tree.getAllocator()));
+			}
+
+			node_type extract(const key_type &k) {
+				node_ptr tmp = _tree.searchTree(k);
+				if (tmp == _tree.getNil())
+					return (node_type());
+				_tree.unlinkNode(tmp);
+				return (node_type(tmp, _tree.getAllocator()));
 			}
 
+			size_type erase(const key_type &k)	{ return (_tree.deleteNode(k) == true) ? 1 : 0;	}
+
+			void erase(iterator first, iterator last)	{ _tree.eraseRange(first.base(), last.base()); }
+
 			iterator find(const key_type &k)	{
 				node_ptr tmp = _tree.searchTree(k);
 				if (tmp == _tree.getNil())
 					return (end());
-				return iterator(tmp, _tree.getRoot(), _tree.getNil());
+				return iterator(tmp);
 			}
 
 			const_iterator find(const key_type &k) const {
 				node_ptr tmp = _tree.searchTree(k);
 				if (tmp == _tree.getNil())
 					return (end());
-				return const_iterator(tmp, _tree.getRoot(), _tree.getNil());
+				return const_iterator(tmp);
 			}
 
 			size_type count(const key_type& k) const	{
-				const_iterator beg = this->begin();
-				const_iterator end = this->end();
-
-				while (beg != end)	{
-					if ((*(beg++)).first == k)
-						return (1);
-				}
-				return (0);
+				node_ptr tmp = _tree.lower_bound_node(k);
+				if (tmp == _tree.getHeader() || _comp(k, tmp->data.first))
+					return (0);
+				return (1);
 			}
 
-			iterator lower_bound(const key_type &k)
-			{
-				iterator beg = this->begin();
-				iterator end = this->end();
-
-				while (beg != end)	{
-					if (_comp((*beg).first, k) == false)
-						break;
-					beg++;
-				}
-				return (beg);
+			iterator 				lower_bound(const key_type &k) { return iterator(_tree.lower_bound_node(k)); }
+			const_iterator 			lower_bound(const key_type &k) const { return const_iterator(_tree.lower_bound_node(k)); }
+			iterator 				upper_bound(const key_type &k) { return iterator(_tree.upper_bound_node(k)); }
+			const_iterator 			upper_bound(const key_type &k) const { return const_iterator(_tree.upper_bound_node(k)); }
+
+			pair<iterator,iterator> 				equal_range(const key_type &k) { return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+			pair<const_iterator,const_iterator> 	equal_range(const key_type &k) const { return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+
+			// find every key of the forward range [first, last) and write its iterator, or end(),
+			// to out in the same order. The descents of a batch of keys are interleaved so that
+			// their cache misses overlap, which pays on maps much larger than the cache
+			template <class ForwardIterator, class OutputIterator>
+			OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) { return (_tree.template findMany<iterator>(first, last, out)); }
+
+			template <class ForwardIterator, class OutputIterator>
+			OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) const { return (_tree.template findMany<const_iterator>(first, last, out)); }
+
+			// lookups by any type a transparent Compare accepts, without building a key_type.
+			// several elements may be equivalent to such a key
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, iterator>::type find(const K &k)	{
+				node_ptr tmp = _tree.searchTree(k);
+				if (tmp == _tree.getNil())
+					return (end());
+				return iterator(tmp);
 			}
 
-			const_iterator lower_bound(const key_type& k) const
-			{
-				const_iterator beg = this->begin();
-				const_iterator end = this->end();
-
-				while (beg != end)	{
-					if (_comp((*beg).first, k) == false)
-						break;
-					beg++;
-				}
-				return (beg);
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, const_iterator>::type find(const K &k) const	{
+				node_ptr tmp = _tree.searchTree(k);
+				if (tmp == _tree.getNil())
+					return (end());
+				return const_iterator(tmp);
 			}
 
-			iterator upper_bound(const key_type& k)
-			{
-				iterator beg = this->begin();
-				iterator end = this->end();
-
-				while (beg != end)	{
-					if (_comp(k ,(*beg).first))
-						break;
-					beg++;
-				}
-				return (beg);
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, size_type>::type count(const K &k) const	{
+				size_type n = 0;
+				for (const_iterator it = lower_bound(k), last = upper_bound(k); it != last; ++it)
+					n++;
+				return (n);
 			}
 
-			const_iterator upper_bound(const key_type& k) const
-			{
-				const_iterator beg = this->begin();
-				const_iterator end = this->end();
-
-				while (beg != end)	{
-					if (_comp(k, (*beg).first))
-						break;
-					beg++;
-				}
-				return (beg);
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, size_type>::type erase(const K &k)	{
+				size_type n = count(k);
+				_tree.eraseRange(_tree.lower_bound_node(k), _tree.upper_bound_node(k));
+				return (n);
 			}
 
-			pair<iterator,iterator> 				equal_range(const key_type &k) { return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
-			pair<const_iterator,const_iterator> 	equal_range(const key_type &k) const { return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, iterator>::type lower_bound(const K &k) { return iterator(_tree.lower_bound_node(k)); }
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, const_iterator>::type lower_bound(const K &k) const { return const_iterator(_tree.lower_bound_node(k)); }
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, iterator>::type upper_bound(const K &k) { return iterator(_tree.upper_bound_node(k)); }
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, const_iterator>::type upper_bound(const K &k) const { return const_iterator(_tree.upper_bound_node(k)); }
+
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, pair<iterator,iterator> >::type equal_range(const K &k) { return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, pair<const_iterator,const_iterator> >::type equal_range(const K &k) const { return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+
+			// split_at moves the elements not less than k to other, whose elements are destroyed.
+			// concat moves all the elements of other here, leaving it empty, when its keys all
+			// come after ours or all before. Within a node pool both relink nodes in O(log n),
+			// without any copy or allocation. With interleaved keys concat moves the elements
+			// one by one instead, and other keeps those whose key is already here.
+			// Every container allocates its nodes from a pool of its own and a node only goes
+			// back to the pool it came from: between two containers, the elements are copied
+			// into the receiving one and destroyed in the other, in O(n)
+			void 					split_at(const key_type &k, map &other) { _tree.split(k, other._tree); }
+			void 					concat(map &other) { _tree.join(other._tree); }
+
+			// in place union and intersection with another map in O(size() + other.size()):
+			// the result is rebuilt as a balanced tree in one pass over both, our elements are
+			// kept over equivalent ones of other, and only the elements added from other are copied
+			void 					merge_from(const map &other) { _tree.unionWith(other._tree); }
+			void 					intersect_with(const map &other) { _tree.intersectWith(other._tree); }
+
+			// move the elements of other whose key is missing here, the others stay in other.
+			// Like concat, the elements of another container are copied then erased from it
+			void 					merge(map &other) { _tree.merge(other._tree); }
+
+# ifdef FT_ORDER_STATISTICS
+			// order statistics in O(log n): the element at position k (end() when k >= size()),
+			// the number of keys less than k and the number of keys in [lo, hi)
+			iterator 				nth(size_type k) { return iterator(_tree.select(k)); }
+			const_iterator 			nth(size_type k) const { return const_iterator(_tree.select(k)); }
+			size_type 				rank(const key_type &k) const { return (_tree.rank(k)); }
+			size_type 				count_range(const key_type &lo, const key_type &hi) const { return (_comp(lo, hi) ? _tree.rank(hi) - _tree.rank(lo) : 0); }
+# endif
 	};
 
 	template <class Key, class T, class Compare, class Alloc>
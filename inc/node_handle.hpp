@@ -0,0 +1,133 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   node_handle.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: chduong <chduong@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/03/05 10:21:37 by chduong           #+#    #+#             */
+/*   Updated: 2023/03/05 10:21:37 by chduong          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef NODE_HANDLE_HPP
+# define NODE_HANDLE_HPP
+# include <cstddef>
+# include <algorithm>
+
+namespace ft
+{
+	// Owner of a node taken out of a map or a set by extract(), until it is given to insert()
+	// of a container with the same node type. Back in the container it came from, the value
+	// stays in the node the whole time: nothing is copied and nothing is allocated. Another
+	// container copies the value into a node of its own pool. The handle keeps a copy of the
+	// allocator of the container the node comes from, which frees the node in every other case.
+	// A handle moves rather than copies: in C++11 through its move operations, in C++98 its
+	// copies take the node away from the source like std::auto_ptr, so that it can be returned
+	// and passed by value.
+	template <class Node, class NodeAlloc>
+	class node_handle_base {
+		public:
+			typedef NodeAlloc 		allocator_type;
+
+		protected:
+			typedef Node* 			node_ptr;
+
+# if __cplusplus >= 201103L
+			node_ptr 				_node;
+# else
+			mutable node_ptr 		_node;
+# endif
+			allocator_type 			_alloc;
+
+		public:
+			node_handle_base(): _node(NULL), _alloc() {}
+			node_handle_base(node_ptr node, const allocator_type &alloc): _node(node), _alloc(alloc) {}
+			~node_handle_base() { reset(NULL); }
+
+# if __cplusplus >= 201103L
+			node_handle_base(node_handle_base &&x): _node(x._node), _alloc(x._alloc) { x._node = NULL; }
+			node_handle_base &operator=(node_handle_base &&x) { reset(x.release()); _alloc = x._alloc; return (*this); }
+			node_handle_base(const node_handle_base &) = delete;
+			node_handle_base &operator=(const node_handle_base &) = delete;
+
+			explicit operator bool() const { return (_node != NULL); }
+# else
+			node_handle_base(const node_handle_base &x): _node(x._node), _alloc(x._alloc) { x._node = NULL; }
+			node_handle_base &operator=(const node_handle_base &x) { node_ptr node = x._node; x._node = NULL; reset(node); _alloc = x._alloc; return (*this); }
+# endif
+
+			bool 				empty() const { return (_node == NULL); }
+			allocator_type 		get_allocator() const { return (_alloc); }
+
+			void 				swap(node_handle_base &x) { node_ptr tmp = _node; _node = x._node; x._node = tmp; std::swap(_alloc, x._alloc); }
+
+			// for the containers: give up the node without destroying it
+			node_ptr 			release() { node_ptr node = _node; _node = NULL; return (node); }
+			node_ptr 			get() const { return (_node); }
+
+		private:
+			void reset(node_ptr node)
+			{
+				if (_node != NULL && _node != node) {
+					_alloc.destroy(_node);
+					_alloc.deallocate(_node, 1);
+				}
+				_node = node;
+			}
+	};
+
+	// node handle of a map, the key can be changed before the node is inserted again
+	template <class Key, class T, class Node, class NodeAlloc>
+	class map_node_handle : public node_handle_base<Node, NodeAlloc> {
+		private:
+			typedef node_handle_base<Node, NodeAlloc> 	base;
+
+		public:
+			typedef Key 								key_type;
+			typedef T 									mapped_type;
+
+			map_node_handle() {}
+			map_node_handle(Node *node, const NodeAlloc &alloc): base(node, alloc) {}
+# if __cplusplus >= 201103L
+			map_node_handle(map_node_handle &&) = default;
+			map_node_handle &operator=(map_node_handle &&) = default;
+# endif
+
+			// the key is const in the node's value_type only to protect the tree it is linked in
+			key_type 		&key() const { return (const_cast<key_type &>(this->_node->data.first)); }
+			mapped_type 	&mapped() const { return (this->_node->data.second); }
+	};
+
+	// node handle of a set
+	template <class Key, class Node, class NodeAlloc>
+	class set_node_handle : public node_handle_base<Node, NodeAlloc> {
+		private:
+			typedef node_handle_base<Node, NodeAlloc> 	base;
+
+		public:
+			typedef Key 								value_type;
+
+			set_node_handle() {}
+			set_node_handle(Node *node, const NodeAlloc &alloc): base(node, alloc) {}
+# if __cplusplus >= 201103L
+			set_node_handle(set_node_handle &&) = default;
+			set_node_handle &operator=(set_node_handle &&) = default;
+# endif
+
+			value_type 		&value() const { return (this->_node->data); }
+	};
+
+	// result of inserting a node handle: on failure, node gives the node back
+	template <class Iterator, class NodeHandle>
+	struct node_insert_return {
+		Iterator 		position;
+		bool 			inserted;
+		NodeHandle 		node;
+
+		node_insert_return(): position(), inserted(false), node() {}
+		node_insert_return(Iterator pos, bool ins, NodeHandle &nh): position(pos), inserted(ins), node() { node.swap(nh); }
+	};
+}
+
+#endif
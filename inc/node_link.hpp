@@ -0,0 +1,208 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   node_link.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: chduong <chduong@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/02/26 10:21:47 by chduong           #+#    #+#             */
+/*   Updated: 2023/02/26 10:21:47 by chduong          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef NODE_LINK_HPP
+# define NODE_LINK_HPP
+# include <cstddef>
+# include <memory>
+# include <new>
+
+namespace ft
+{
+	// Node pointer whose lowest bit, always clear in a node address, carries a flag.
+	// Assigning a new target keeps the flag; copy construction copies both.
+	template <class Node>
+	class tagged_link {
+		private:
+			size_t 			_bits;
+
+		public:
+			tagged_link() : _bits(0) {}
+			explicit tagged_link(Node *ptr, bool flag = false) : _bits(reinterpret_cast<size_t>(ptr) | flag) {}
+			tagged_link(const tagged_link &src) : _bits(src._bits) {}
+
+			tagged_link &operator=(const tagged_link &rhs) { return (*this = static_cast<Node *>(rhs)); }
+			tagged_link &operator=(Node *ptr) {
+				_bits = reinterpret_cast<size_t>(ptr) | (_bits & 1);
+				return (*this);
+			}
+
+			operator Node*() const { return (reinterpret_cast<Node *>(_bits & ~static_cast<size_t>(1))); }
+			Node 			*operator->() const { return (static_cast<Node *>(*this)); }
+
+			bool 			flag() const { return (_bits & 1); }
+			void 			setFlag(bool flag) { _bits = (_bits & ~static_cast<size_t>(1)) | flag; }
+	};
+
+	// smallest power of two, at least 4096, holding 256 objects of Size bytes
+	template <size_t Size, size_t Bytes = 4096, bool Fits = (Bytes >= 256 * Size)>
+	struct page_size { enum { value = page_size<Size, Bytes * 2, (Bytes * 2 >= 256 * Size)>::value }; };
+
+	template <size_t Size, size_t Bytes>
+	struct page_size<Size, Bytes, true> { enum { value = Bytes }; };
+
+	// number of bits needed to count up to N
+	template <size_t N, size_t Bits = 0, bool Done = ((static_cast<size_t>(1) << Bits) >= N)>
+	struct count_bits { enum { value = count_bits<N, Bits + 1, ((static_cast<size_t>(1) << (Bits + 1)) >= N)>::value }; };
+
+	template <size_t N, size_t Bits>
+	struct count_bits<N, Bits, true> { enum { value = Bits }; };
+
+	// Registry of the pages node_pool carves nodes from when FT_INDEX_NODES is defined.
+	// A page starts on a multiple of its size with a header holding its number, so a
+	// node address gives its 32 bit index with a mask and the index gives the address
+	// back with a table lookup. An index is the page number followed by slot_bits bits
+	// of position in the page. Index 0 is NULL: page 0 is never handed out.
+	// The registry is shared by every pool of the process: add and remove take a lock,
+	// and lookups, which do not, read the table through an acquire load. A table that
+	// grew stays allocated, chained behind the one replacing it, as a lookup on another
+	// thread may still be reading it; they are all freed with the last page.
+	template <class Node>
+	class node_pages {
+		private:
+			struct page_header { size_t id; };
+
+			static Node 		**_table;		// first node of every page, by page number, then the previous table
+			static Node 		*_no_page[2];
+			static size_t 		_capacity;
+			static size_t 		_first_free;	// lowest unused page number
+			static size_t 		_used;
+			static int 			_lock;
+
+			struct lock_guard {
+				lock_guard() { while (__sync_lock_test_and_set(&_lock, 1)) ; }
+				~lock_guard() { __sync_lock_release(&_lock); }
+			};
+
+		public:
+			enum {
+				page_bytes = page_size<sizeof(Node)>::value,
+				header_slots = (sizeof(page_header) + sizeof(Node) - 1) / sizeof(Node),
+				page_slots = page_bytes / sizeof(Node) - header_slots,
+				slot_bits = count_bits<page_slots>::value,
+				max_index = 0x7fffffff	// one bit of every link is kept for the color
+			};
+
+			static Node *at(size_t index) { return (__atomic_load_n(&_table, __ATOMIC_ACQUIRE)[index >> slot_bits] + (index & ((1 << slot_bits) - 1))); }
+
+			static size_t index_of(const Node *node)
+			{
+				if (node == NULL)
+					return (0);
+				const page_header *page = reinterpret_cast<const page_header *>(reinterpret_cast<size_t>(node) & ~static_cast<size_t>(page_bytes - 1));
+				return ((page->id << slot_bits) + (node - reinterpret_cast<const Node *>(page) - header_slots));
+			}
+
+			// first address at or after p where a page may start
+			static char *align(char *p)
+			{
+				size_t offset = reinterpret_cast<size_t>(p) & (page_bytes - 1);
+				return (offset ? p + (page_bytes - offset) : p);
+			}
+
+			// number the page starting at base and return its first node
+			static Node *add(char *base)
+			{
+				lock_guard 	lock;
+
+				if (_first_free == _capacity)
+					grow();
+				if (((_first_free + 1) << slot_bits) > static_cast<size_t>(max_index))
+					throw std::bad_alloc();
+				reinterpret_cast<page_header *>(base)->id = _first_free;
+				_table[_first_free] = reinterpret_cast<Node *>(base) + header_slots;
+				_used++;
+				while (_first_free < _capacity && _table[_first_free] != NULL)
+					_first_free++;
+				return (reinterpret_cast<Node *>(base) + header_slots);
+			}
+
+			static void remove(char *base)
+			{
+				lock_guard 	lock;
+				size_t 		id = reinterpret_cast<page_header *>(base)->id;
+
+				_table[id] = NULL;
+				if (id < _first_free)
+					_first_free = id;
+				if (--_used == 0) { // no index is left to look up
+					while (_table != _no_page) {
+						Node **prev = reinterpret_cast<Node **>(_table[_capacity]);
+						std::allocator<Node *>().deallocate(_table, _capacity + 1);
+						__atomic_store_n(&_table, prev, __ATOMIC_RELEASE);
+						_capacity = (_capacity == 64) ? 1 : _capacity / 2;
+					}
+					_first_free = 1;
+				}
+			}
+
+		private:
+			static void grow()
+			{
+				size_t 	capacity = _capacity < 64 ? 64 : _capacity * 2;
+				Node 	**table = std::allocator<Node *>().allocate(capacity + 1);
+
+				for (size_t i = 0; i < capacity; i++)
+					table[i] = i < _capacity ? _table[i] : NULL;
+				table[capacity] = reinterpret_cast<Node *>(_table);
+				__atomic_store_n(&_table, table, __ATOMIC_RELEASE);
+				_capacity = capacity;
+			}
+	};
+
+	template <class Node>
+	Node *node_pages<Node>::_no_page[2] = {NULL, NULL};
+
+	template <class Node>
+	Node **node_pages<Node>::_table = node_pages<Node>::_no_page;
+
+	template <class Node>
+	size_t node_pages<Node>::_capacity = 1;
+
+	template <class Node>
+	size_t node_pages<Node>::_first_free = 1;
+
+	template <class Node>
+	size_t node_pages<Node>::_used = 0;
+
+	template <class Node>
+	int node_pages<Node>::_lock = 0;
+
+	// 32 bit node index into node_pages, with a flag in its lowest bit like tagged_link
+	template <class Node>
+	class index_link {
+		private:
+			unsigned int 	_bits;
+
+		public:
+			index_link() : _bits(0) {}
+			explicit index_link(Node *ptr, bool flag = false) : _bits(static_cast<unsigned int>(node_pages<Node>::index_of(ptr) << 1) | flag) {}
+			index_link(const index_link &src) : _bits(src._bits) {}
+
+			index_link &operator=(const index_link &rhs) {
+				_bits = (rhs._bits & ~1U) | (_bits & 1U);
+				return (*this);
+			}
+			index_link &operator=(Node *ptr) {
+				_bits = static_cast<unsigned int>(node_pages<Node>::index_of(ptr) << 1) | (_bits & 1U);
+				return (*this);
+			}
+
+			operator Node*() const { return (node_pages<Node>::at(_bits >> 1)); }
+			Node 			*operator->() const { return (static_cast<Node *>(*this)); }
+
+			bool 			flag() const { return (_bits & 1U); }
+			void 			setFlag(bool flag) { _bits = (_bits & ~1U) | flag; }
+	};
+}
+
+#endif
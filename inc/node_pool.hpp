@@ -0,0 +1,308 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   node_pool.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: chduong <chduong@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/02/25 11:02:17 by chduong           #+#    #+#             */
+/*   Updated: 2023/02/25 11:02:17 by chduong          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef NODE_POOL_HPP
+# define NODE_POOL_HPP
+# include <cstddef>
+# include <cstring>
+# include <memory>
+# include <new>
+# ifdef FT_INDEX_NODES
+#  include "node_link.hpp"
+# endif
+
+namespace ft
+{
+	// Allocator handing out single nodes from large chunks obtained through Alloc.
+	// Freed nodes go to an intrusive free list and are reused before any new chunk
+	// is requested; the chunks go back to Alloc once every node has been released.
+	// Every container builds its own pool from its allocator, and copies of a pool share
+	// its state, so two pools compare equal when they hand out nodes from the same chunks.
+	// A pool is not synchronized, but containers with pools of their own do not share anything:
+	// a node only ever goes back to the pool it came from.
+	// With FT_INDEX_NODES the chunks are cut into pages registered in node_pages<T>,
+	// so that every node can be named by a 32 bit index.
+	// allocate_run hands out many nodes at once, side by side in a chunk of their own,
+	// for a container to lay its nodes out in the order it reads them.
+	template <class T, class Alloc = std::allocator<T> >
+	class node_pool {
+		public:
+			typedef T 														value_type;
+			typedef T* 														pointer;
+			typedef const T* 												const_pointer;
+			typedef T& 														reference;
+			typedef const T& 												const_reference;
+			typedef size_t 													size_type;
+			typedef ptrdiff_t 												difference_type;
+
+			template <class U> struct rebind { typedef node_pool<U, Alloc> other; };
+
+		private:
+			template <class, class> friend class node_pool;
+
+			typedef typename Alloc::template rebind<T>::other 				chunk_allocator;
+# ifdef FT_INDEX_NODES
+			typedef node_pages<T> 											pages;
+# endif
+
+			struct chunk_header { pointer prev; size_type count; };
+
+			struct pool_state {
+				size_type 		refs;			// node_pools using this state
+				pointer 		free;			// nodes given back, reused first, chained through their first bytes
+				pointer 		cursor;			// first never used node of the newest chunk
+				pointer 		end;			// end of the newest chunk
+				pointer 		chunks;			// newest chunk, older ones are chained through their header
+				size_type 		next_count;		// size in nodes of the next chunk
+				size_type 		live;			// nodes currently handed out
+			};
+
+			typedef typename Alloc::template rebind<pool_state>::other 		state_allocator;
+
+			chunk_allocator 												_chunk_alloc;
+			pool_state 														*_state; // NULL until the first allocation
+
+			enum {
+				first_chunk = 64,
+				max_chunk = 16384,
+				header_slots = (sizeof(chunk_header) + sizeof(T) - 1) / sizeof(T)
+			};
+
+		public:
+			node_pool(): _chunk_alloc(), _state(NULL) {}
+			explicit node_pool(const Alloc &alloc): _chunk_alloc(alloc), _state(NULL) {}
+			node_pool(const node_pool &src): _chunk_alloc(src._chunk_alloc), _state(src._state) { if (_state != NULL) _state->refs++; }
+			template <class U> node_pool(const node_pool<U, Alloc> &src): _chunk_alloc(src._chunk_alloc), _state(NULL) {} // a pool of its own
+			~node_pool() { drop(_state); }
+
+			node_pool &operator=(const node_pool &rhs)
+			{
+				if (rhs._state != NULL)
+					rhs._state->refs++;
+				drop(_state);
+				_state = rhs._state;
+				_chunk_alloc = rhs._chunk_alloc;
+				return (*this);
+			}
+
+			pointer 			address(reference x) const { return (&x); }
+			const_pointer 		address(const_reference x) const { return (&x); }
+			size_type 			max_size() const { return (_chunk_alloc.max_size()); }
+
+			void 				construct(pointer p, const_reference val) { new (static_cast<void *>(p)) T(val); }
+			void 				destroy(pointer p) { p->~T(); }
+
+			pointer allocate(size_type n, const void * = 0)
+			{
+				pointer p;
+
+				if (n != 1)
+					return (_chunk_alloc.allocate(n));
+				pool_state &s = state();
+				if (s.free == NULL && s.cursor == s.end)
+					grow(s);
+				if (s.free != NULL) {
+					p = s.free;
+					s.free = nextFree(p);
+				}
+				else
+					p = s.cursor++;
+				s.live++;
+				return (p);
+			}
+
+			void deallocate(pointer p, size_type n)
+			{
+				if (n != 1) {
+					_chunk_alloc.deallocate(p, n);
+					return;
+				}
+				pool_state &s = state();
+				setNextFree(p, s.free);
+				s.free = p;
+				if (--s.live == 0)
+					release(s);
+			}
+
+			// n nodes one after the other in a new chunk, the first is returned and next_in_run
+			// gives the following ones. Each is given back to deallocate like any other node
+			pointer allocate_run(size_type n)
+			{
+				pointer first;
+
+				if (n == 0)
+					return (NULL);
+				pool_state &s = state();
+# ifdef FT_INDEX_NODES
+				size_type 	page_count = (n + pages::page_slots - 1) / pages::page_slots + 1; // one more to align the first page
+				first = addPages(s, newChunk(s, header_slots + (page_count * pages::page_bytes + sizeof(T) - 1) / sizeof(T)), n);
+# else
+				first = newChunk(s, n + header_slots) + header_slots;
+# endif
+				s.live += n;
+				return (first);
+			}
+
+			// node following p in a run, the first of the next page when p ends its page
+			static pointer next_in_run(pointer p)
+			{
+# ifdef FT_INDEX_NODES
+				char 		*page = reinterpret_cast<char *>(reinterpret_cast<size_t>(p) & ~static_cast<size_t>(pages::page_bytes - 1));
+				if (p + 1 == reinterpret_cast<pointer>(page) + pages::header_slots + pages::page_slots)
+					return (reinterpret_cast<pointer>(page + pages::page_bytes) + pages::header_slots);
+# endif
+				return (p + 1);
+			}
+
+			// what copies of a pool have in common, NULL before the first allocation
+			const void 			*identity() const { return (_state); }
+
+		private:
+			// a free node holds the next one's address, copied bytewise: nodes may be less aligned than pointers
+			static pointer 		nextFree(pointer p) { pointer next; std::memcpy(&next, static_cast<void *>(p), sizeof(next)); return (next); }
+			static void 		setNextFree(pointer p, pointer next) { std::memcpy(static_cast<void *>(p), &next, sizeof(next)); }
+
+			static void reset(pool_state &s)
+			{
+				s.free = NULL;
+				s.cursor = NULL;
+				s.end = NULL;
+				s.chunks = NULL;
+				s.next_count = first_chunk;
+				s.live = 0;
+			}
+
+			// the state this pool allocates from, created on first use
+			pool_state &state()
+			{
+				if (_state == NULL) {
+					state_allocator alloc(_chunk_alloc);
+					_state = alloc.allocate(1);
+					_state->refs = 1;
+					reset(*_state);
+				}
+				return (*_state);
+			}
+
+			// one user of s less. The last one gives the chunks back, even if nodes are still out:
+			// nobody could free them anymore
+			void drop(pool_state *s)
+			{
+				if (s != NULL && --s->refs == 0) {
+					release(*s);
+					state_allocator(_chunk_alloc).deallocate(s, 1);
+				}
+			}
+
+			void grow(pool_state &s)
+			{
+				size_type 		count = s.next_count < (size_type)first_chunk ? (size_type)first_chunk : s.next_count;
+# ifdef FT_INDEX_NODES
+				if (count < (size_type)pages::page_slots)
+					count = pages::page_slots;
+				size_type 		total = count + header_slots + pages::page_bytes / sizeof(T) + 1; // room to align the first page
+# else
+				size_type 		total = count + header_slots;
+# endif
+				pointer 		chunk = newChunk(s, total);
+
+# ifdef FT_INDEX_NODES
+				addPages(s, chunk, 0);
+# else
+				s.cursor = chunk + header_slots;
+				s.end = s.cursor + count;
+# endif
+				s.next_count = count < (size_type)max_chunk ? count * 2 : (size_type)max_chunk;
+			}
+
+			// chunk of total slots, header included, chained to the others
+			pointer newChunk(pool_state &s, size_type total)
+			{
+				pointer 		chunk = _chunk_alloc.allocate(total);
+				chunk_header 	*header = reinterpret_cast<chunk_header *>(chunk);
+
+				header->prev = s.chunks;
+				header->count = total;
+				s.chunks = chunk;
+				return (chunk);
+			}
+
+			// every node is back: give all the chunks back to Alloc
+			void release(pool_state &s)
+			{
+				while (s.chunks != NULL) {
+					chunk_header *header = reinterpret_cast<chunk_header *>(s.chunks);
+					pointer prev = header->prev;
+# ifdef FT_INDEX_NODES
+					char *end = reinterpret_cast<char *>(s.chunks + header->count);
+					for (char *page = firstPage(s.chunks); page + pageRoom() <= end; page += pages::page_bytes)
+						pages::remove(page);
+# endif
+					_chunk_alloc.deallocate(s.chunks, header->count);
+					s.chunks = prev;
+				}
+				reset(s);
+			}
+
+# ifdef FT_INDEX_NODES
+			static char 		*firstPage(pointer chunk) { return (pages::align(reinterpret_cast<char *>(chunk + header_slots))); }
+			static size_type 	pageRoom() { return ((pages::header_slots + 1) * sizeof(T)); } // smallest useful page
+
+			// register every page of a new chunk and queue its nodes on the free list in address
+			// order, but for the first taken ones, which are handed out as a run. Returns the first node
+			static pointer addPages(pool_state &s, pointer chunk, size_type taken)
+			{
+				char 		*end = reinterpret_cast<char *>(chunk + reinterpret_cast<chunk_header *>(chunk)->count);
+				pointer 	head = NULL;
+				pointer 	tail = NULL;
+				pointer 	run = NULL;
+
+				for (char *page = firstPage(chunk); page + pageRoom() <= end; page += pages::page_bytes) {
+					pointer first = pages::add(page);
+					pointer last = first + pages::page_slots;
+					if (run == NULL)
+						run = first;
+					if (reinterpret_cast<char *>(last) > end) // the chunk ends inside this page
+						last = first + (end - reinterpret_cast<char *>(first)) / sizeof(T);
+					for (pointer p = first; p != last; p++) {
+						if (taken > 0)
+							taken--;
+						else if (tail == NULL)
+							head = tail = p;
+						else {
+							setNextFree(tail, p);
+							tail = p;
+						}
+					}
+				}
+				if (tail != NULL) {
+					setNextFree(tail, s.free);
+					s.free = head;
+				}
+				return (run);
+			}
+# endif
+	};
+
+	template <class T1, class T2, class Alloc>
+	bool operator==(const node_pool<T1, Alloc> &lhs, const node_pool<T2, Alloc> &rhs)
+	{
+		if (lhs.identity() == NULL) // nothing allocated yet: only equal to itself
+			return (static_cast<const void *>(&lhs) == static_cast<const void *>(&rhs));
+		return (lhs.identity() == rhs.identity());
+	}
+
+	template <class T1, class T2, class Alloc>
+	bool operator!=(const node_pool<T1, Alloc> &lhs, const node_pool<T2, Alloc> &rhs) { return (!(lhs == rhs)); }
+}
+
+#endif
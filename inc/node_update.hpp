@@ -0,0 +1,65 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   node_update.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: chduong <chduong@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/03/04 15:12:40 by chduong           #+#    #+#             */
+/*   Updated: 2023/03/04 15:12:40 by chduong          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef NODE_UPDATE_HPP
+# define NODE_UPDATE_HPP
+# include <cstddef>
+
+namespace ft
+{
+	// Node update policies augment every node of an RBTree with some metadata about its subtree.
+	// A policy provides:
+	//   metadata             a base class of every RBNode, default constructed, which is also
+	//                        the value held by the sentinel leaf
+	//   active               false when there is nothing to maintain, so RBTree skips the calls
+	//   operator()(node, nil) recompute the metadata of node from node->data and the metadata
+	//                        of its two children, either of which may be nil
+	// RBTree calls it on a node after each rotation and structural change below it, children
+	// before parents, so every node is up to date once an insertion or erase returns.
+
+	// no metadata at all
+	struct null_node_update {
+		struct metadata {};
+
+		enum { active = false };
+
+		template <class Node>
+		void operator()(Node *, const Node *) const {}
+	};
+
+	// the number of nodes in every subtree, for rank and select in O(log n)
+	struct order_statistics_node_update {
+		struct metadata {
+			size_t 	count;
+
+			metadata() : count(0) {}
+		};
+
+		enum { active = true };
+
+		template <class Node>
+		void operator()(Node *node, const Node *) const { node->count = node->left->count + node->right->count + 1; }
+	};
+
+	// number of nodes under a node whose metadata counts them, size_t(-1) when it does not
+	inline size_t subtree_size(const void *) { return (static_cast<size_t>(-1)); }
+	inline size_t subtree_size(const order_statistics_node_update::metadata *node) { return (node->count); }
+
+	// policy of map and set: order statistics are opt-in through FT_ORDER_STATISTICS
+# ifdef FT_ORDER_STATISTICS
+	typedef order_statistics_node_update 	default_node_update;
+# else
+	typedef null_node_update 				default_node_update;
+# endif
+}
+
+#endif
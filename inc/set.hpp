@@ -15,6 +15,8 @@
 # include <memory>
 # include "iterator.hpp"
 # include "RBTree.hpp"
+# include "node_pool.hpp"
+# include "node_handle.hpp"
 
 namespace ft
 {
@@ -32,15 +34,7 @@ namespace ft
 			typedef typename allocator_type::difference_type 										difference_type;
 			typedef typename allocator_type::size_type 												size_type;
 
-			class value_compare : public std::binary_function<value_type, value_type, bool> {
-				friend class set;
-				protected:
-					Compare						comp;
-					value_compare(Compare c) : comp(c) {}
-					
-				public:
-					bool			operator()(const key_type& x, const key_type& y) const		{return comp(x, y);}
-			};
+			typedef Compare 																		value_compare; // values are their own keys, like in std::set
 
 		private:
 			template <class _T, class _Key>
@@ -48,15 +42,18 @@ namespace ft
 				const _Key &operator()(const _T &x) const {return (x);}
 			};
 	
-			typedef ft::RBTree<key_type, value_type, get_key<value_type, key_type>, value_compare> 	tree_type;
-			typedef typename tree_type::node_type 													node_type;
+			typedef ft::node_pool<RBNode<value_type>, allocator_type> 								node_allocator;
+			typedef ft::RBTree<key_type, value_type, get_key<value_type, key_type>, value_compare, node_allocator> 	tree_type;
+			typedef typename tree_type::node_type 													tree_node;
 			typedef typename tree_type::node_ptr 													node_ptr;
 		
 		public:
-			typedef ft::tree_iterator<value_type const, node_type const> 							iterator;
-			typedef ft::tree_iterator<value_type const, node_type const> 							const_iterator;
-			typedef ft::reverse_iterator<iterator> 													reverse_iterator;
-			typedef ft::reverse_iterator<const_iterator> 											const_reverse_iterator;
+			typedef ft::tree_iterator<value_type const, tree_node const> 							iterator;
+			typedef ft::tree_iterator<value_type const, tree_node const> 							const_iterator;
+			typedef ft::tree_reverse_iterator<value_type const, tree_node const> 					reverse_iterator;
+			typedef ft::tree_reverse_iterator<value_type const, tree_node const> 					const_reverse_iterator;
+			typedef ft::set_node_handle<value_type, tree_node, node_allocator> 					node_type;
+			typedef ft::node_insert_return<iterator, node_type> 									insert_return_type;
 
 		private:
 			key_compare 					_comp;
@@ -64,68 +61,110 @@ namespace ft
 			tree_type 						_tree;
 
 		public:
-			explicit set(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()): _comp(comp), _alloc(alloc), _tree(value_comp()) {}
+			explicit set(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()): _comp(comp), _alloc(alloc), _tree(value_comp(), node_allocator(_alloc)) {}
 			
 			template <class InputIterator>
 			set(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
-			: _comp(comp), _alloc(alloc), _tree(value_comp()) {insert(first, last);}
+			: _comp(comp), _alloc(alloc), _tree(value_comp(), node_allocator(_alloc)) {insert(first, last);}
 			
-			set(const set &x): _comp(x._comp), _alloc(x._alloc), _tree(value_comp())	{insert(x.begin(), x.end());}
+			set(const set &x): _comp(x._comp), _alloc(x._alloc), _tree(value_comp(), node_allocator(_alloc)) {_tree.clone(x._tree);}
 			
 			~set() {}
 
 			set &operator=(const set &x) {
 				if (this == &x)
 					return (*this);
-				if (_tree.getRoot() != _tree.getNil())
-					clear();
 				this->_comp = x._comp;
 				this->_alloc = x._alloc;
-				insert(x.begin(), x.end());
+				_tree.clone(x._tree);
 				return *this;
 			}
 
-			iterator					begin() { return iterator(_tree.minimum(_tree.getRoot()), _tree.getRoot(), _tree.getNil());}
-			const_iterator				begin() const { return const_iterator(_tree.minimum(_tree.getRoot()), _tree.getRoot(), _tree.getNil());}
-			iterator					end() { return iterator(_tree.getNil(), _tree.getRoot(), _tree.getNil());}
-			const_iterator				end() const { return const_iterator(_tree.getNil(), _tree.getRoot(), _tree.getNil());}
-			reverse_iterator			rbegin() { return reverse_iterator(end());}
-			const_reverse_iterator		rbegin() const { return const_reverse_iterator(end());}
-			reverse_iterator			rend() { return reverse_iterator(begin());}
-			const_reverse_iterator		rend() const { return const_reverse_iterator(begin());}
+			iterator					begin() { return iterator(_tree.getHeader()->left);}
+			const_iterator				begin() const { return const_iterator(_tree.getHeader()->left);}
+			iterator					end() { return iterator(_tree.getHeader());}
+			const_iterator				end() const { return const_iterator(_tree.getHeader());}
+			reverse_iterator			rbegin() { return reverse_iterator(_tree.getHeader()->right);}
+			const_reverse_iterator		rbegin() const { return const_reverse_iterator(_tree.getHeader()->right);}
+			reverse_iterator			rend() { return reverse_iterator(_tree.getHeader());}
+			const_reverse_iterator		rend() const { return const_reverse_iterator(_tree.getHeader());}
 
 			bool						empty() const { return (_tree.getSize() == 0);}
 			size_type					size() const { return (_tree.getSize());}
 			size_type					max_size() const { return (_tree.max_size());}
 			
-			void 						swap (set &x) {_tree.swap(x._tree);}
+			void 						swap (set &x) {_tree.swap(x._tree); std::swap(_comp, x._comp); std::swap(_alloc, x._alloc);}
 			void 						clear() {_tree.clear_h(_tree.getRoot());}
+
+			// move every element into one block, in key order or in van Emde Boas order, so that
+			// scans or lookups touch fewer cache lines and pages. Invalidates every iterator
+			void 						compact(NodeLayout layout = in_order_layout) {_tree.compact(layout);}
 			
 			key_compare 				key_comp() const { return (this->_comp); }
 			value_compare 				value_comp() const { return (value_compare(this->_comp));}
 			allocator_type				get_allocator() const { return (_alloc); }
 			
 			ft::pair<iterator,bool> insert(const value_type &val)	{
-				iterator it = find(val);
-				if (it != end())
-					return (ft::pair<iterator,bool>(it, false));
-				else
-				{
-					_tree.insertNode(val);
-					it = find(val);
-					return (ft::pair<iterator,bool>(it, true));
-				}
+				ft::pair<node_ptr, bool> ret = _tree.insert_unique(val);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
 			}
 
-			iterator insert(iterator position, const value_type &val)	{(void)position; return (insert(val).first);}
+			// build the element from its arguments right in the new node
+# if __cplusplus >= 201103L
+			template <class... Args>
+			ft::pair<iterator,bool> emplace(Args&&... args)	{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_unique(std::forward<Args>(args)...);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+# else
+			template <class A1>
+			ft::pair<iterator,bool> emplace(const A1 &a1)	{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_unique(a1);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+
+			template <class A1, class A2>
+			ft::pair<iterator,bool> emplace(const A1 &a1, const A2 &a2)	{
+				ft::pair<node_ptr, bool> ret = _tree.emplace_unique(a1, a2);
+				return (ft::pair<iterator,bool>(iterator(ret.first), ret.second));
+			}
+# endif
+
+			iterator insert(iterator position, const value_type &val)	{
+				return iterator(_tree.insert_hint(const_cast<node_ptr>(position.base()), val).first);
+			}
 
 			template <class InputIterator>
 			void insert(InputIterator first, InputIterator last) {
-				while (first != last)
-					insert(*(first++)); // first here is a bidirectional_iterator which has an * overload so *first = first._ptr->_data which is a pair in set so a value_type
+				_tree.insert_range(first, last);
 			}
 
-			void erase(iterator position) {	erase((*position)); }
+			// link the node of nh, unless its value is already here: nh then gets it back in the result
+			insert_return_type insert(node_type nh) {
+				if (nh.empty())
+					return (insert_return_type(end(), false, nh));
+				ft::pair<node_ptr, bool> ret = _tree.reinsertNode(nh.get(), nh.get_allocator());
+				if (ret.second)
+					nh.release();
+				return (insert_return_type(iterator(ret.first), ret.second, nh));
+			}
+
+			void erase(iterator position) {	_tree.eraseNode(const_cast<node_ptr>(position.base())); }
+
+			// unlink an element and hand its node over, neither destroyed nor copied
+			node_type extract(iterator position) {
+				node_ptr node = const_cast<node_ptr>(position.base());
+				_tree.unlinkNode(node);
+				return (node_type(node, _tree.getAllocator()));
+			}
+
+			node_type extract(const value_type &k) {
+				node_ptr tmp = _tree.searchTree(k);
+				if (tmp == _tree.getNil())
+					return (node_type());
+				_tree.unlinkNode(tmp);
+				return (node_type(tmp, _tree.getAllocator()));
+			}
 
 			size_type erase(const value_type &k) {
 				if (_tree.deleteNode(k) == true)
@@ -133,55 +172,94 @@ namespace ft
 				return 0;
 			}
 
-			void erase(iterator first, iterator last) {
-				while(first != last)
-					erase(*(first++));
-			}
+			void erase(iterator first, iterator last) { _tree.eraseRange(const_cast<node_ptr>(first.base()), const_cast<node_ptr>(last.base())); }
 
 			iterator find(const value_type &k) const	{
 				node_ptr tmp = _tree.searchTree(k);
 				if (tmp == _tree.getNil())
 					return (end());
-				return iterator(tmp, _tree.getRoot(), _tree.getNil());
+				return iterator(tmp);
 			}
 
 			size_type count(const value_type &k) const	{
-				const_iterator beg = this->begin();
-				const_iterator end = this->end();
-
-				while (beg != end)	{
-					if (*(beg++) == k)
-						return (1);
-				}
-				return (0);
+				node_ptr tmp = _tree.lower_bound_node(k);
+				if (tmp == _tree.getHeader() || _comp(k, tmp->data))
+					return (0);
+				return (1);
 			}
 
-			iterator lower_bound(const value_type &k) const	{
-				iterator beg = this->begin();
-				iterator end = this->end();
+			iterator lower_bound(const value_type &k) const { return iterator(_tree.lower_bound_node(k)); }
+			iterator upper_bound(const value_type &k) const { return iterator(_tree.upper_bound_node(k)); }
+			
+			pair<iterator,iterator> equal_range(const value_type &k) const {return (ft::make_pair(this->lower_bound(k), this->upper_bound(k)));}
 
-				while (beg != end)	{
-					if (_comp((*beg), k) == false)
-						break;
-					beg++;
-				}
-				return (beg);
+			// find every key of the forward range [first, last) and write its iterator, or end(),
+			// to out in the same order. The descents of a batch of keys are interleaved so that
+			// their cache misses overlap, which pays on sets much larger than the cache
+			template <class ForwardIterator, class OutputIterator>
+			OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator out) const { return (_tree.template findMany<iterator>(first, last, out)); }
+
+			// lookups by any type a transparent Compare accepts, without building a value_type.
+			// several elements may be equivalent to such a key
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, iterator>::type find(const K &k) const	{
+				node_ptr tmp = _tree.searchTree(k);
+				if (tmp == _tree.getNil())
+					return (end());
+				return iterator(tmp);
 			}
 
-			iterator upper_bound(const value_type &k) const	{
-				iterator beg = this->begin();
-				iterator end = this->end();
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, size_type>::type count(const K &k) const	{
+				size_type n = 0;
+				for (iterator it = lower_bound(k), last = upper_bound(k); it != last; ++it)
+					n++;
+				return (n);
+			}
 
-				while (beg != end)			{
-					if (_comp(k ,(*beg)))
-						break;
-					beg++;
-				}
-				return (beg);
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, size_type>::type erase(const K &k)	{
+				size_type n = count(k);
+				_tree.eraseRange(_tree.lower_bound_node(k), _tree.upper_bound_node(k));
+				return (n);
 			}
-			
-			pair<iterator,iterator> equal_range(const value_type &k) const {return (ft::make_pair(this->lower_bound(k), this->upper_bound(k)));}
 
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, iterator>::type lower_bound(const K &k) const { return iterator(_tree.lower_bound_node(k)); }
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, iterator>::type upper_bound(const K &k) const { return iterator(_tree.upper_bound_node(k)); }
+
+			template <class K>
+			typename ft::enable_if_transparent<key_compare, K, pair<iterator,iterator> >::type equal_range(const K &k) const {return (ft::make_pair(this->lower_bound(k), this->upper_bound(k)));}
+
+			// split_at moves the elements not less than k to other, whose elements are destroyed.
+			// concat moves all the elements of other here, leaving it empty, when its keys all
+			// come after ours or all before. Within a node pool both relink nodes in O(log n),
+			// without any copy or allocation. With interleaved keys concat moves the elements
+			// one by one instead, and other keeps those whose key is already here.
+			// Every container allocates its nodes from a pool of its own and a node only goes
+			// back to the pool it came from: between two containers, the elements are copied
+			// into the receiving one and destroyed in the other, in O(n)
+			void 					split_at(const value_type &k, set &other) { _tree.split(k, other._tree); }
+			void 					concat(set &other) { _tree.join(other._tree); }
+
+			// in place union and intersection with another set in O(size() + other.size()):
+			// the result is rebuilt as a balanced tree in one pass over both, our elements are
+			// kept over equivalent ones of other, and only the elements added from other are copied
+			void 					merge_from(const set &other) { _tree.unionWith(other._tree); }
+			void 					intersect_with(const set &other) { _tree.intersectWith(other._tree); }
+
+			// move the elements of other whose value is missing here, the others stay in other.
+			// Like concat, the elements of another container are copied then erased from it
+			void 					merge(set &other) { _tree.merge(other._tree); }
+
+# ifdef FT_ORDER_STATISTICS
+			// order statistics in O(log n): the element at position k (end() when k >= size()),
+			// the number of keys less than k and the number of keys in [lo, hi)
+			iterator 	nth(size_type k) const { return iterator(_tree.select(k)); }
+			size_type 	rank(const value_type &k) const { return (_tree.rank(k)); }
+			size_type 	count_range(const value_type &lo, const value_type &hi) const { return (_comp(lo, hi) ? _tree.rank(hi) - _tree.rank(lo) : 0); }
+# endif
 	};
 
 	template <class T, class Compare, class Alloc>
@@ -201,6 +279,9 @@ namespace ft
 
 	template <class T, class Compare, class Alloc>
 	bool operator>=(const set<T, Compare, Alloc> &lhs, const set<T, Compare, Alloc> &rhs) {return (!(lhs < rhs));}
+
+	template <class T, class Compare, class Alloc>
+	void swap(set<T, Compare, Alloc> &lhs, set<T, Compare, Alloc> &rhs) { lhs.swap(rhs);}
 }
 
 #endif
@@ -44,6 +44,50 @@ namespace ft
     template <> class is_integral<unsigned short> : public true_type {};
     template <> class is_integral<unsigned int> : public true_type {};
     template <> class is_integral<unsigned long> : public true_type {};
+
+    // true when a T can be copied bytewise with memcpy and left to die without its destructor.
+    // GCC and Clang know it for any type, class types included; elsewhere only integral
+    // types and pointers are recognized, which is always safe
+# if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+    template <class T> struct is_trivially_copyable : public integral_constant<bool, __is_trivially_copyable(T)> {};
+# else
+    template <class T> struct is_trivially_copyable : public integral_constant<bool, is_integral<T>::value> {};
+    template <class T> struct is_trivially_copyable<T *> : public true_type {};
+# endif
+
+# if defined(__clang__)
+    template <class T> struct is_trivially_destructible : public integral_constant<bool, __is_trivially_destructible(T)> {};
+# elif defined(__GNUC__)
+    template <class T> struct is_trivially_destructible : public integral_constant<bool, __has_trivial_destructor(T)> {};
+# else
+    template <class T> struct is_trivially_destructible : public is_trivially_copyable<T> {};
+# endif
+
+    // true when a T can be moved to another address bytewise, the old bytes being then
+    // forgotten rather than destroyed. ft::vector then moves such elements with memmove
+    // when it grows, inserts or erases. Trivially copyable types are; specialize it to
+    // true_type for other types that hold no pointer into themselves, such as most handles
+    // to heap memory. Not libstdc++'s std::string since C++11: its short strings point
+    // into their own buffer
+    template <class T> struct is_trivially_relocatable : public is_trivially_copyable<T> {};
+
+    // true when Compare declares an is_transparent member type: it then compares keys of any type
+    template <class Compare> class is_transparent {
+        private:
+            typedef char                    yes;
+            typedef struct { char c[2]; }   no;
+
+            template <class C> static yes   test(typename C::is_transparent *);
+            template <class C> static no    test(...);
+
+        public:
+            static bool const               value = sizeof(test<Compare>(0)) == sizeof(yes);
+    };
+
+    // enable_if for the heterogeneous lookups of map and set: the condition has to
+    // depend on the looked up type K for the overload to be discarded rather than rejected
+    template <class Compare, class K, class T>
+    struct enable_if_transparent : public enable_if<is_transparent<Compare>::value, T> {};
 }
 
 #endif
@@ -12,9 +12,16 @@
 
 #ifndef UTILITY_HPP
 # define UTILITY_HPP
+# if __cplusplus >= 201103L
+#  include <utility>
+# endif
 
 namespace ft 
 {
+	// tag of the pair constructor that copies first and value-initializes second,
+	// so that a map builds the element of a new key in one step
+	struct default_second_t {};
+
 	template <class T1, class T2> struct pair {
 		typedef T1 		first_type;
 		typedef T2 		second_type;
@@ -24,7 +31,20 @@ namespace ft
 		
 		pair() : first(T1()), second(T2()) {}
 		pair(const T1& a, const T2& b) : first(a), second(b) {}
+		pair(default_second_t, const T1& a) : first(a), second() {}
 		~pair() {}
+
+		// members built straight from any arguments they accept, as in C++11
+# if __cplusplus >= 201103L
+		pair(const pair &) = default;
+		pair(pair &&) = default;
+
+		template <class U, class V>
+		pair(U&& a, V&& b) : first(std::forward<U>(a)), second(std::forward<V>(b)) {}
+# else
+		template <class U, class V>
+		pair(const U& a, const V& b) : first(a), second(b) {}
+# endif
 		
 		template <class U, class V>
 		pair(const pair<U,V>& pr) : first(pr.first), second(pr.second) {}
@@ -35,6 +55,14 @@ namespace ft
 			return (*this);
 		}
 
+# if __cplusplus >= 201103L
+		pair& operator=(pair&& other) {
+			first = std::move(other.first);
+			second = std::move(other.second);
+			return (*this);
+		}
+# endif
+
 	};
 	
 	template <class T1, class T2>
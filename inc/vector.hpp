@@ -12,6 +12,9 @@
 
 #ifndef VECTOR_HPP
 # define VECTOR_HPP
+# include <algorithm>
+# include <cstring>
+# include <iterator>
 # include <memory>
 # include <stdexcept>
 # include "utility.hpp"
@@ -58,12 +61,13 @@ namespace ft {
 		template <class InputIterator>
 		vector(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(), typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = NULL)
 		: _alloc(alloc), _data(NULL), _capacity(0), _size(0) {
-			for (; first != last; first++)
-				push_back(*first);
+			initRange(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
 		}
 
 		// Copy constructor
-		vector(const vector& x) : _alloc(allocator_type()), _data(NULL), _capacity(0), _size(0) {*this = x;}
+		vector(const vector& x) : _alloc(allocator_type()), _data(NULL), _capacity(0), _size(0) {
+			initRange(x._data, x._data + x._size, std::random_access_iterator_tag());
+		}
 
 		~vector() {
 			clear();
@@ -73,10 +77,8 @@ namespace ft {
 
 		// Assign content
 		vector& operator=(const vector& x) {
-			if (this != &x) {
-				clear();
-				assign(x.begin(), x.end());
-			}
+			if (this != &x)
+				assignRange(x._data, x._data + x._size, std::random_access_iterator_tag());
 			return (*this);
 		}
 
@@ -99,8 +101,7 @@ namespace ft {
 		void 	resize(size_type n, value_type val = value_type()) {
 			// Si n est plus petit que la taille actuelle, détruire les éléments supplémentaires
 		    if (n < _size) {
-				for (size_type i = n; i < _size; i++)
-					_alloc.destroy(_data + i);
+				destroy(_data + n, _data + _size);
 			} else if (n > _size) { // Si n est plus grand que la taille actuelle, ajouter des éléments avec la valeur val
 				if (n > _capacity)
 					reserve(n);
@@ -116,9 +117,13 @@ namespace ft {
 			// Allouer de la nouvelle mémoire et déplacer les éléments
 			if (n > _capacity) {
 				pointer new_data = _alloc.allocate(n);
-				for (size_type i = 0; i < _size; i++) {
-					_alloc.construct(new_data + i, *(_data + i));
-					_alloc.destroy(_data + i);
+				if (ft::is_trivially_relocatable<value_type>::value) {
+					relocate(new_data, _data, _size);
+				} else {
+					for (size_type i = 0; i < _size; i++) {
+						_alloc.construct(new_data + i, *(_data + i));
+						_alloc.destroy(_data + i);
+					}
 				}
 				_alloc.deallocate(_data, _capacity);
 				_data = new_data;
@@ -150,11 +155,7 @@ namespace ft {
 		// Assigns new contents to the vector, replacing its current contents, and modifying its size accordingly.
 		template <class InputIterator>
 		void	assign (InputIterator first, InputIterator last, typename enable_if<!is_integral<InputIterator>::value>::type* = 0) {
-			this->clear();
-			while (first != last) {
-				push_back(*first);
-				++first;
-			}
+			assignRange(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
 		}
 		
 		void	assign(size_type n, const value_type& val) {
@@ -190,65 +191,76 @@ namespace ft {
 			return (iterator(&this->_data[n]));
 		}
 		void insert (iterator position, size_type n, const value_type& val) {
-			vector tmp(position, end());
-			this->_size -= std::distance(position, end());
-			while (n) {
-				push_back(val);
-				--n;
+			size_type	offset = position - begin();
+			value_type	copy(val); // val may be one of the elements about to move
+
+			if (n == 0)
+				return;
+			if (_size + n > _capacity) {
+				size_type	new_capacity = grownCapacity(n);
+				pointer		new_data = _alloc.allocate(new_capacity);
+				try {
+					constructFill(new_data + offset, n, copy);
+				} catch (...) {
+					_alloc.deallocate(new_data, new_capacity);
+					throw;
+				}
+				moveAround(new_data, new_capacity, offset, n);
+				return;
 			}
-			iterator it = tmp.begin();
-			while (it != tmp.end()) {
-				push_back(*it);
-				++it;
+			pointer p = _data + offset;
+			pointer old_end = _data + _size;
+			size_type after = _size - offset;
+			if (ft::is_trivially_relocatable<value_type>::value) {
+				relocate(p + n, p, after);
+				try {
+					constructFill(p, n, copy);
+				} catch (...) {
+					relocate(p, p + n, after);
+					throw;
+				}
+				_size += n;
+			} else if (after > n) {
+				constructCopies(old_end - n, old_end, old_end);
+				_size += n;
+				std::copy_backward(p, old_end - n, old_end);
+				std::fill(p, p + n, copy);
+			} else {
+				constructFill(old_end, n - after, copy);
+				_size += n - after;
+				constructCopies(p, old_end, _data + _size);
+				_size += after;
+				std::fill(p, old_end, copy);
 			}
 		}
 		template <class InputIterator>
 		void insert (iterator position, InputIterator first, InputIterator last, typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type * = 0) {
-			vector tmp(position, end());
-			this->_size -= std::distance(position, end());
-			while (first != last) {
-				push_back(*first);
-				++first;
-			}
-			iterator it = tmp.begin();
-			while (it != tmp.end()) {
-				push_back(*it);
-				++it;
-			}
+			insertRange(position, first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
 		}
 
 		// Removes from the vector either a single element (position) or a range of elements ([first,last]).
+		// The tail is shifted down in one pass, bytewise when the elements can be relocated and by
+		// assignment otherwise, and only the elements left over at the end are destroyed.
 		iterator erase(iterator position) {
 			if (empty())
 				return (end());
-			iterator it = begin();
-			while (it != position)
-				it++;
-			_alloc.destroy(&(*it));
-			while (it + 1 != end()) {
-				_alloc.construct(&(*it), *(it + 1));
-				it++;
-			}
-			pop_back();
-			return (position);
+			return (erase(position, position + 1));
 		}
 		iterator erase(iterator first, iterator last) {
-			if (empty())
-				return (end());
-			iterator it = begin();
-			iterator rtn = first;
-			difference_type dist = last - first;
-			while (it != first)
-				it++;
-			for (; first != last; first++)
-				_alloc.destroy(&(*first));
-			while (it + dist != end()) {
-				_alloc.construct(&(*it), *(it + dist));
-				it++;
+			pointer p = first.base();
+			pointer q = last.base();
+			pointer old_end = _data + _size;
+
+			if (p == q)
+				return (first);
+			if (ft::is_trivially_relocatable<value_type>::value) {
+				destroy(p, q);
+				relocate(p, q, old_end - q);
 			}
-			while (dist-- > 0)
-				pop_back();
-			return (rtn);
+			else
+				destroy(std::copy(q, old_end, p), old_end);
+			_size -= q - p;
+			return (first);
 		}
 
 		void swap(vector& x) {
@@ -258,15 +270,213 @@ namespace ft {
 		}
 
 		void clear() {
-			if (_size > 0) {
-				for (iterator it = begin(); it != end(); it++)
-					_alloc.destroy(&(*it));
-				_size = 0;
-			}
+			destroy(_data, _data + _size);
+			_size = 0;
 		}
 
 		// Allocator
 		allocator_type get_allocator() const {return _alloc;}
+
+	private:
+		// Input ranges can only be read once, the vector grows as they go.
+		template <class InputIterator>
+		void initRange(InputIterator first, InputIterator last, std::input_iterator_tag) {
+			try {
+				for (; first != last; ++first)
+					push_back(*first);
+			} catch (...) {
+				clear();
+				if (_capacity > 0)
+					_alloc.deallocate(_data, _capacity);
+				throw;
+			}
+		}
+
+		// Forward ranges are counted first: one allocation of the exact size.
+		template <class ForwardIterator>
+		void initRange(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+			size_type n = std::distance(first, last);
+
+			if (n == 0)
+				return;
+			if (n > max_size())
+				throw std::length_error("vector");
+			_data = _alloc.allocate(n);
+			_capacity = n;
+			try {
+				constructCopies(first, last, _data);
+			} catch (...) {
+				_alloc.deallocate(_data, n);
+				throw;
+			}
+			_size = n;
+		}
+
+		template <class InputIterator>
+		void assignRange(InputIterator first, InputIterator last, std::input_iterator_tag) {
+			clear();
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+
+		// The elements already there are assigned to, a range larger than the capacity is copied to a block of its size.
+		template <class ForwardIterator>
+		void assignRange(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+			size_type n = std::distance(first, last);
+
+			if (n > _capacity) {
+				vector tmp(first, last);
+				swap(tmp);
+			} else if (n <= _size) {
+				destroy(std::copy(first, last, _data), _data + _size);
+				_size = n;
+			} else {
+				ForwardIterator mid = first;
+				std::advance(mid, _size);
+				std::copy(first, mid, _data);
+				constructCopies(mid, last, _data + _size);
+				_size = n;
+			}
+		}
+
+		// Input ranges can only be read once: they are gathered first, to be inserted in one go.
+		template <class InputIterator>
+		void insertRange(iterator position, InputIterator first, InputIterator last, std::input_iterator_tag) {
+			vector tmp(first, last);
+			insertRange(position, tmp.begin(), tmp.end(), std::random_access_iterator_tag());
+		}
+
+		// Same as inserting n copies of a value, with n known from the start.
+		template <class ForwardIterator>
+		void insertRange(iterator position, ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+			size_type	offset = position - begin();
+			size_type	n = std::distance(first, last);
+
+			if (n == 0)
+				return;
+			if (_size + n > _capacity) {
+				size_type	new_capacity = grownCapacity(n);
+				pointer		new_data = _alloc.allocate(new_capacity);
+				try {
+					constructCopies(first, last, new_data + offset);
+				} catch (...) {
+					_alloc.deallocate(new_data, new_capacity);
+					throw;
+				}
+				moveAround(new_data, new_capacity, offset, n);
+				return;
+			}
+			pointer p = _data + offset;
+			pointer old_end = _data + _size;
+			size_type after = _size - offset;
+			if (ft::is_trivially_relocatable<value_type>::value) {
+				relocate(p + n, p, after);
+				try {
+					constructCopies(first, last, p);
+				} catch (...) {
+					relocate(p, p + n, after);
+					throw;
+				}
+				_size += n;
+			} else if (after > n) {
+				constructCopies(old_end - n, old_end, old_end);
+				_size += n;
+				std::copy_backward(p, old_end - n, old_end);
+				std::copy(first, last, p);
+			} else {
+				ForwardIterator mid = first;
+				std::advance(mid, after);
+				constructCopies(mid, last, old_end);
+				_size += n - after;
+				constructCopies(p, old_end, _data + _size);
+				_size += after;
+				std::copy(first, mid, p);
+			}
+		}
+
+		// Capacity after inserting n elements: the vector at least doubles, like push_back.
+		size_type grownCapacity(size_type n) const {
+			if (n > max_size() - _size)
+				throw std::length_error("vector::insert");
+			return (_size + (n > _size ? n : _size));
+		}
+
+		// Moves the elements to new_data, where n new elements are already built at offset, and frees the old block.
+		void moveAround(pointer new_data, size_type new_capacity, size_type offset, size_type n) {
+			if (ft::is_trivially_relocatable<value_type>::value) {
+				relocate(new_data, _data, offset);
+				relocate(new_data + offset + n, _data + offset, _size - offset);
+			} else {
+				try {
+					constructCopies(_data, _data + offset, new_data);
+				} catch (...) {
+					destroy(new_data + offset, new_data + offset + n);
+					_alloc.deallocate(new_data, new_capacity);
+					throw;
+				}
+				try {
+					constructCopies(_data + offset, _data + _size, new_data + offset + n);
+				} catch (...) {
+					destroy(new_data, new_data + offset + n);
+					_alloc.deallocate(new_data, new_capacity);
+					throw;
+				}
+				destroy(_data, _data + _size);
+			}
+			if (_capacity > 0)
+				_alloc.deallocate(_data, _capacity);
+			_data = new_data;
+			_capacity = new_capacity;
+			_size += n;
+		}
+
+		// Copy-constructs [first, last) into the raw memory at dst. On an exception, destroys what it built.
+		template <class InputIterator>
+		pointer constructCopies(InputIterator first, InputIterator last, pointer dst) {
+			pointer cur = dst;
+			try {
+				for (; first != last; ++first, ++cur)
+					_alloc.construct(cur, *first);
+			} catch (...) {
+				destroy(dst, cur);
+				throw;
+			}
+			return (cur);
+		}
+
+		// Same from elements of a vector, all at once for trivially copyable types.
+		pointer constructCopies(pointer first, pointer last, pointer dst) {
+			if (!ft::is_trivially_copyable<value_type>::value)
+				return (constructCopies<pointer>(first, last, dst));
+			if (first != last)
+				std::memcpy(static_cast<void *>(dst), static_cast<void *>(first), (last - first) * sizeof(value_type));
+			return (dst + (last - first));
+		}
+
+		// Constructs n copies of val into the raw memory at dst. On an exception, destroys what it built.
+		void constructFill(pointer dst, size_type n, const value_type& val) {
+			size_type i = 0;
+			try {
+				for (; i < n; i++)
+					_alloc.construct(dst + i, val);
+			} catch (...) {
+				destroy(dst, dst + i);
+				throw;
+			}
+		}
+
+		// Moves n trivially relocatable elements to dst bytewise, the ranges may overlap.
+		static void relocate(pointer dst, pointer src, size_type n) {
+			if (n > 0)
+				std::memmove(static_cast<void *>(dst), static_cast<void *>(src), n * sizeof(value_type));
+		}
+
+		// Destroys the elements of [first, last), nothing to do for trivially destructible types.
+		void destroy(pointer first, pointer last) {
+			if (!ft::is_trivially_destructible<value_type>::value)
+				for (; first != last; first++)
+					_alloc.destroy(first);
+		}
 	};
 
 	// Non-member function overloads
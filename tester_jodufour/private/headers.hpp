@@ -16,6 +16,7 @@
 # define VECTOR_HEADER "vector.hpp"
 # define STACK_HEADER "stack.hpp"
 # define MAP_HEADER "map.hpp"
+# define INTERVAL_MAP_HEADER "interval_map.hpp"
 # define SET_HEADER "set.hpp"
 # define ITERATOR_TRAITS_HEADER "iterator.hpp"
 # define REVERSE_ITERATOR_HEADER "iterator.hpp"
@@ -23,6 +24,7 @@
 # define IS_INTEGRAL_HEADER "type_traits.hpp"
 # define EQUAL_HEADER "algorithm.hpp"
 # define LEXICOGRAPHICAL_COMPARE_HEADER "algorithm.hpp"
+# define SET_OPERATIONS_HEADER "algorithm.hpp"
 # define PAIR_HEADER "utility.hpp"
 # define MAKE_PAIR_HEADER "utility.hpp"
 
@@ -30,6 +30,9 @@ struct s_test
 	bool				run_as_default;
 };
 
+int	bench_map(void);
+int	bench_vector(void);
+
 int	test_algorithm(void);
 int	test_is_integral(void);
 int	test_map(void);
@@ -0,0 +1,80 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   values.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: chduong <chduong@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/02/20 14:31:59 by chduong          #+#    #+#             */
+/*   Updated: 2023/02/20 14:31:59 by chduong         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef VALUES_HPP
+# define VALUES_HPP
+
+# include "t_int.hpp"
+# include <stdexcept>
+
+/**
+ * @brief	Value whose copy constructor throws once a given number of copies have been made.
+ * 			Counts the instances alive.
+ */
+struct __throwing_copy
+{
+	static int	copies_left;
+	static int	alive;
+
+	int	value;
+
+	__throwing_copy(int const value = 0) : value(value) { ++alive; }
+	__throwing_copy(__throwing_copy const &src) : value(src.value)
+	{
+		if (copies_left-- == 0)
+			throw std::runtime_error("copy");
+		++alive;
+	}
+	~__throwing_copy(void) { --alive; }
+
+	bool	operator<(__throwing_copy const &rhs) const { return value < rhs.value; }
+};
+
+/**
+ * @brief	Value counting how many times it gets constructed, copied or assigned.
+ */
+class __counted
+{
+	public:
+		static t_uint	constructions;
+		static t_uint	copies;
+		static t_uint	assignments;
+
+		int	value;
+
+		__counted(void) : value(0) { ++constructions; }
+		__counted(int const value) : value(value) { ++constructions; }
+		__counted(__counted const &src) : value(src.value) { ++constructions; ++copies; }
+# if __cplusplus >= 201103L
+		__counted(__counted &&src) : value(src.value) {}
+		__counted	&operator=(__counted &&rhs) { value = rhs.value; ++assignments; return *this; }
+# endif
+		~__counted(void) {}
+
+		__counted	&operator=(__counted const &rhs) { value = rhs.value; ++assignments; return *this; }
+
+		static void	reset(void) { constructions = 0U; copies = 0U; assignments = 0U; }
+};
+
+/**
+ * @brief	Transparent comparator: __counted values can be looked up by plain int.
+ */
+struct __counted_less
+{
+	typedef void	is_transparent;
+
+	bool	operator()(__counted const &lhs, __counted const &rhs) const { return lhs.value < rhs.value; }
+	bool	operator()(__counted const &lhs, int const rhs) const { return lhs.value < rhs; }
+	bool	operator()(int const lhs, __counted const &rhs) const { return lhs < rhs.value; }
+};
+
+#endif
@@ -0,0 +1,980 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_map.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: chduong <chduong@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/02/24 10:12:41 by chduong           #+#    #+#             */
+/*   Updated: 2023/02/24 10:12:41 by chduong          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "colors.hpp"
+#include "e_ret.hpp"
+#include "headers.hpp"
+#include "tester.hpp"
+#include "t_int.hpp"
+#include MAP_HEADER
+#include INTERVAL_MAP_HEADER
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+static t_uint const	g_bench_size[] = {
+	1000U,
+	1000000U,
+	10000000U,
+};
+static size_t const	g_bench_size_size = sizeof(g_bench_size) / sizeof(*g_bench_size);
+
+static t_uint const	g_query_count = 100000U;
+
+static t_uint const	g_interval_size[] = {
+	1000U,
+	100000U,
+	1000000U,
+};
+static size_t const	g_interval_size_size = sizeof(g_interval_size) / sizeof(*g_interval_size);
+
+static t_uint const	g_window_count = 1000U;
+static t_uint const	g_window_length = 64U;
+
+static size_t		g_allocation_count = 0U;
+static size_t		g_allocated_bytes = 0U;
+static size_t		g_copy_count = 0U;
+
+/**
+ * @brief	std::allocator that counts every call to allocate() and the bytes requested,
+ * 			whatever type it has been rebound to.
+ */
+template <typename T>
+class counting_allocator : public std::allocator<T>
+{
+	public:
+		template <typename U>
+		struct rebind
+		{
+			typedef counting_allocator<U>	other;
+		};
+
+		counting_allocator(void) : std::allocator<T>() {}
+		counting_allocator(counting_allocator const &src) : std::allocator<T>(src) {}
+		template <typename U>
+		counting_allocator(counting_allocator<U> const &src) : std::allocator<T>(src) {}
+		~counting_allocator(void) {}
+
+		T	*allocate(size_t const n, void const *const hint = 0)
+		{
+			++g_allocation_count;
+			g_allocated_bytes += n * sizeof(T);
+			return std::allocator<T>::allocate(n, hint);
+		}
+};
+
+/**
+ * @brief	A large value that counts how many times it gets copied.
+ */
+struct counted_value
+{
+	std::string	payload;
+
+	counted_value(void) : payload(256U, '*') {}
+	counted_value(counted_value const &src) : payload(src.payload) { ++g_copy_count; }
+	counted_value	&operator=(counted_value const &rhs) { payload = rhs.payload; ++g_copy_count; return *this; }
+};
+
+/**
+ * @brief	Display one line of a benchmark: the duration of both implementations
+ * 			for a given container size, and how they compare.
+ */
+inline static void	__report(t_uint const size, clock_t const ft_duration, clock_t const std_duration)
+{
+	float const	ft_ms = 1000.0f * ft_duration / CLOCKS_PER_SEC;
+	float const	std_ms = 1000.0f * std_duration / CLOCKS_PER_SEC;
+	float const	ratio = static_cast<float>(ft_duration + !ft_duration) / static_cast<float>(std_duration + !std_duration);
+
+	std::cout << "    " << std::setw(9) << size << " keys : ft " << std::setw(10) << ft_ms << " ms, std " << std::setw(10) << std_ms << " ms ";
+	if (ratio < 1.0f)
+	{
+		std::cerr << GREEN_FG;
+		std::cout << '(' << 1.0f / ratio << "x faster)";
+	}
+	else
+	{
+		std::cerr << (ratio < 2.0f ? GREEN_FG : (ratio < 10.0f ? YELLOW_FG : RED_FG));
+		std::cout << '(' << ratio << "x slower)";
+	}
+	std::cerr << RESET;
+	std::cout << '\n';
+}
+
+template <typename Map>
+inline static void	__fill(Map &map, t_uint const size)
+{
+	t_uint	idx;
+
+	for (idx = 0U ; idx < size ; ++idx)
+		map[static_cast<int>(idx * 2U)] = idx;
+}
+
+inline static void	__random_keys(std::vector<int> &keys, t_uint const count, t_uint const range)
+{
+	t_uint	idx;
+
+	keys.resize(count);
+	for (idx = 0U ; idx < count ; ++idx)
+		keys[idx] = static_cast<int>(static_cast<t_uint>(rand()) % (range * 2U + 1U));
+}
+
+template <typename Map>
+inline static clock_t	__time_bounds(Map const &map, std::vector<int> const &keys, size_t &sink)
+{
+	clock_t	start;
+	size_t	idx;
+
+	start = clock();
+	for (idx = 0U ; idx < keys.size() ; ++idx)
+	{
+		sink += map.lower_bound(keys[idx]) == map.end();
+		sink += map.upper_bound(keys[idx]) == map.end();
+		sink += map.count(keys[idx]);
+	}
+	return clock() - start;
+}
+
+inline static int	__test_bounds(void)
+{
+	std::vector<int>	keys;
+	clock_t				ft_duration;
+	clock_t				std_duration;
+	size_t				ft_sink;
+	size_t				std_sink;
+	size_t				idx;
+
+	title(__func__);
+	std::cout << g_query_count << " x (lower_bound + upper_bound + count)\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		__random_keys(keys, g_query_count, g_bench_size[idx]);
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::map<int, t_uint>	ft_map;
+
+			__fill(ft_map, g_bench_size[idx]);
+			ft_duration = __time_bounds(ft_map, keys, ft_sink);
+		}
+		{
+			std::map<int, t_uint>	std_map;
+
+			__fill(std_map, g_bench_size[idx]);
+			std_duration = __time_bounds(std_map, keys, std_sink);
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Map>
+inline static clock_t	__time_finds(Map const &map, std::vector<int> const &keys, size_t &sink)
+{
+	clock_t	start;
+	size_t	idx;
+
+	start = clock();
+	for (idx = 0U ; idx < keys.size() ; ++idx)
+		sink += map.find(keys[idx]) != map.end();
+	return clock() - start;
+}
+
+inline static int	__test_find_many(void)
+{
+	typedef ft::map<int, t_uint>	t_ft_map;
+
+	std::vector<int>						keys;
+	std::vector<t_ft_map::const_iterator>	found;
+	clock_t									batched_duration;
+	clock_t									ft_duration;
+	clock_t									std_duration;
+	size_t									batched_sink;
+	size_t									ft_sink;
+	size_t									std_sink;
+	size_t									idx;
+	size_t									key;
+
+	title(__func__);
+	std::cout << g_query_count << " x find, looked up together by ft::map::find_many (ft), one at a time by std::map::find (std)\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		__random_keys(keys, g_query_count, g_bench_size[idx]);
+		found.resize(keys.size());
+		batched_sink = 0U;
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			t_ft_map	ft_map;
+
+			__fill(ft_map, g_bench_size[idx]);
+			ft_duration = __time_finds(ft_map, keys, ft_sink);
+			batched_duration = clock();
+			ft_map.find_many(keys.begin(), keys.end(), found.begin());
+			for (key = 0U ; key < found.size() ; ++key)
+				batched_sink += found[key] != ft_map.end();
+			batched_duration = clock() - batched_duration;
+		}
+		{
+			std::map<int, t_uint>	std_map;
+
+			__fill(std_map, g_bench_size[idx]);
+			std_duration = __time_finds(std_map, keys, std_sink);
+		}
+		__report(g_bench_size[idx], batched_duration, std_duration);
+		std::cout << "                     Mkeys/s: find_many " << keys.size() / (1000.0f * batched_duration / CLOCKS_PER_SEC + 1e-3f) / 1000.0f
+			<< ", ft::map::find " << keys.size() / (1000.0f * ft_duration / CLOCKS_PER_SEC + 1e-3f) / 1000.0f << '\n';
+		if (batched_sink != std_sink || ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Map, typename Pair>
+inline static clock_t	__time_hinted_ingest(Map &map, t_uint const size)
+{
+	clock_t	start;
+	t_uint	idx;
+
+	start = clock();
+	for (idx = 0U ; idx < size ; ++idx)
+		map.insert(map.end(), Pair(static_cast<int>(idx), idx));
+	return clock() - start;
+}
+
+inline static int	__test_hinted_ingest(void)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	idx;
+	bool	same;
+
+	title(__func__);
+	std::cout << "sorted keys, insert(end(), value)\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		ft::map<int, t_uint>	ft_map;
+		std::map<int, t_uint>	std_map;
+
+		ft_duration = __time_hinted_ingest<ft::map<int, t_uint>, ft::pair<int, t_uint> >(ft_map, g_bench_size[idx]);
+		std_duration = __time_hinted_ingest<std::map<int, t_uint>, std::pair<int, t_uint> >(std_map, g_bench_size[idx]);
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		same = ft_map.size() == std_map.size() && ft_map.rbegin()->first == std_map.rbegin()->first;
+		if (!same)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_sorted_construction(void)
+{
+	clock_t	start;
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	idx;
+	t_uint	key;
+	bool	same;
+
+	title(__func__);
+	std::cout << "map(first, last) from a sorted vector\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		{
+			std::vector<ft::pair<int, t_uint> >	ft_vec;
+
+			for (key = 0U ; key < g_bench_size[idx] ; ++key)
+				ft_vec.push_back(ft::pair<int, t_uint>(static_cast<int>(key), key));
+			start = clock();
+			ft::map<int, t_uint> const			ft_map(ft_vec.begin(), ft_vec.end());
+			ft_duration = clock() - start;
+			same = ft_map.size() == g_bench_size[idx];
+		}
+		{
+			std::vector<std::pair<int, t_uint> >	std_vec;
+
+			for (key = 0U ; key < g_bench_size[idx] ; ++key)
+				std_vec.push_back(std::pair<int, t_uint>(static_cast<int>(key), key));
+			start = clock();
+			std::map<int, t_uint> const				std_map(std_vec.begin(), std_vec.end());
+			std_duration = clock() - start;
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		if (!same)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Map>
+inline static clock_t	__time_copy(Map const &src, Map &dst)
+{
+	clock_t	start;
+
+	start = clock();
+	{
+		Map const	copy(src);
+
+		dst = copy; // dst already holds as many nodes as copy: assignment can recycle them
+	}
+	return clock() - start;
+}
+
+inline static int	__test_copy(void)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	idx;
+	bool	same;
+
+	title(__func__);
+	std::cout << "map(const map &) + operator= onto a map of the same size\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		{
+			ft::map<int, t_uint>	ft_src;
+			ft::map<int, t_uint>	ft_dst;
+
+			__fill(ft_src, g_bench_size[idx]);
+			__fill(ft_dst, g_bench_size[idx]);
+			ft_duration = __time_copy(ft_src, ft_dst);
+			same = ft_dst.size() == g_bench_size[idx] && ft_dst == ft_src;
+		}
+		{
+			std::map<int, t_uint>	std_src;
+			std::map<int, t_uint>	std_dst;
+
+			__fill(std_src, g_bench_size[idx]);
+			__fill(std_dst, g_bench_size[idx]);
+			std_duration = __time_copy(std_src, std_dst);
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		if (!same)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Map, typename Pair>
+inline static clock_t	__time_churn(Map &map, std::vector<int> const &keys, t_uint const size, size_t &allocations)
+{
+	clock_t	start;
+	size_t	idx;
+
+	g_allocation_count = 0U;
+	start = clock();
+	for (idx = 0U ; idx < keys.size() ; ++idx)
+	{
+		map.erase(map.lower_bound(keys[idx]) == map.end() ? map.begin()->first : map.lower_bound(keys[idx])->first);
+		map.insert(Pair(static_cast<int>(size * 2U + idx), idx));
+	}
+	allocations = g_allocation_count;
+	return clock() - start;
+}
+
+inline static int	__test_churn_allocations(void)
+{
+	std::vector<int>	keys;
+	clock_t				ft_duration;
+	clock_t				std_duration;
+	size_t				ft_allocations;
+	size_t				std_allocations;
+	size_t				idx;
+	bool				same;
+
+	title(__func__);
+	std::cout << g_query_count << " x (erase + insert), counting calls to Alloc::allocate\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		__random_keys(keys, g_query_count, g_bench_size[idx]);
+		{
+			ft::map<int, t_uint, std::less<int>, counting_allocator<ft::pair<int const, t_uint> > >	ft_map;
+
+			__fill(ft_map, g_bench_size[idx]);
+			ft_duration = __time_churn<ft::map<int, t_uint, std::less<int>, counting_allocator<ft::pair<int const, t_uint> > >, ft::pair<int, t_uint> >(ft_map, keys, g_bench_size[idx], ft_allocations);
+			same = ft_map.size() == g_bench_size[idx];
+		}
+		{
+			std::map<int, t_uint, std::less<int>, counting_allocator<std::pair<int const, t_uint> > >	std_map;
+
+			__fill(std_map, g_bench_size[idx]);
+			std_duration = __time_churn<std::map<int, t_uint, std::less<int>, counting_allocator<std::pair<int const, t_uint> > >, std::pair<int, t_uint> >(std_map, keys, g_bench_size[idx], std_allocations);
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		std::cout << "                     allocations per operation: ft " << static_cast<float>(ft_allocations) / (2U * keys.size())
+			<< ", std " << static_cast<float>(std_allocations) / (2U * keys.size()) << '\n';
+		if (!same)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_node_transfer(void)
+{
+	std::vector<int>	keys;
+	clock_t				ft_duration;
+	clock_t				std_duration;
+	size_t				ft_copies;
+	size_t				std_copies;
+	size_t				ft_sink;
+	size_t				std_sink;
+	size_t				idx;
+	size_t				key;
+
+	title(__func__);
+	std::cout << g_query_count << " x move an entry from an active map to an expired one, counting value copies\n";
+	for (idx = 0U ; idx < g_bench_size_size - 1U ; ++idx)
+	{
+		__random_keys(keys, g_query_count, g_bench_size[idx]);
+		{
+			ft::map<int, counted_value>	ft_active;
+			ft::map<int, counted_value>	ft_expired;
+
+			for (key = 0U ; key <= g_bench_size[idx] * 2U ; ++key)
+				ft_active[static_cast<int>(key)];
+			g_copy_count = 0U;
+			ft_duration = clock();
+			for (key = 0U ; key < keys.size() ; ++key)
+			{
+				ft::map<int, counted_value>::node_type	nh = ft_active.extract(keys[key]);
+
+				if (!nh.empty())
+					ft_expired.insert(nh);
+			}
+			ft_duration = clock() - ft_duration;
+			ft_copies = g_copy_count;
+			ft_sink = ft_active.size() + ft_expired.size() * 2U;
+		}
+		{
+			std::map<int, counted_value>	std_active;
+			std::map<int, counted_value>	std_expired;
+
+			for (key = 0U ; key <= g_bench_size[idx] * 2U ; ++key)
+				std_active[static_cast<int>(key)];
+			g_copy_count = 0U;
+			std_duration = clock();
+			for (key = 0U ; key < keys.size() ; ++key)
+			{
+				std::map<int, counted_value>::iterator	it = std_active.find(keys[key]);
+
+				if (it != std_active.end())
+				{
+					std_expired.insert(*it);
+					std_active.erase(it);
+				}
+			}
+			std_duration = clock() - std_duration;
+			std_copies = g_copy_count;
+			std_sink = std_active.size() + std_expired.size() * 2U;
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		std::cout << "                     value copies per move: ft " << static_cast<float>(ft_copies) / keys.size()
+			<< ", std " << static_cast<float>(std_copies) / keys.size() << '\n';
+		if (ft_sink != std_sink || ft_copies != 0U)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Map>
+inline static clock_t	__time_iteration(Map const &map, size_t &sink)
+{
+	typename Map::const_iterator			it;
+	typename Map::const_reverse_iterator	rit;
+	clock_t									start;
+
+	start = clock();
+	for (it = map.begin() ; it != map.end() ; ++it)
+		sink += it->second;
+	for (rit = map.rbegin() ; rit != map.rend() ; ++rit)
+		sink -= rit->second;
+	sink += (--map.end())->first;
+	return clock() - start;
+}
+
+inline static int	__test_iteration(void)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+
+	title(__func__);
+	std::cout << "begin() to end() then rbegin() to rend()\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::map<int, t_uint>	ft_map;
+
+			__fill(ft_map, g_bench_size[idx]);
+			ft_duration = __time_iteration(ft_map, ft_sink);
+		}
+		{
+			std::map<int, t_uint>	std_map;
+
+			__fill(std_map, g_bench_size[idx]);
+			std_duration = __time_iteration(std_map, std_sink);
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Map>
+inline static void	__time_directions(Map const &map, clock_t &forward, clock_t &reverse, size_t &sink)
+{
+	typename Map::const_iterator			it;
+	typename Map::const_reverse_iterator	rit;
+
+	forward = clock();
+	for (it = map.begin() ; it != map.end() ; ++it)
+		sink += it->second;
+	forward = clock() - forward;
+	reverse = clock();
+	for (rit = map.rbegin() ; rit != map.rend() ; ++rit)
+		sink -= rit->second;
+	reverse = clock() - reverse;
+}
+
+inline static int	__test_reverse_iteration(void)
+{
+	clock_t	ft_forward;
+	clock_t	ft_reverse;
+	clock_t	std_forward;
+	clock_t	std_reverse;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+
+	title(__func__);
+	std::cout << "rbegin() to rend(), and its cost relative to begin() to end()\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::map<int, t_uint>	ft_map;
+
+			__fill(ft_map, g_bench_size[idx]);
+			__time_directions(ft_map, ft_forward, ft_reverse, ft_sink);
+		}
+		{
+			std::map<int, t_uint>	std_map;
+
+			__fill(std_map, g_bench_size[idx]);
+			__time_directions(std_map, std_forward, std_reverse, std_sink);
+		}
+		__report(g_bench_size[idx], ft_reverse, std_reverse);
+		std::cout << "                     reverse / forward: ft " << static_cast<float>(ft_reverse + !ft_reverse) / (ft_forward + !ft_forward)
+			<< ", std " << static_cast<float>(std_reverse + !std_reverse) / (std_forward + !std_forward) << '\n';
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_iteration_shuffled(void)
+{
+	std::vector<int>	keys;
+	clock_t				ft_duration;
+	clock_t				std_duration;
+	size_t				ft_sink;
+	size_t				std_sink;
+	size_t				idx;
+	size_t				key;
+
+	title(__func__);
+	std::cout << "same scans, keys inserted in random order so that nodes are scattered in memory\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		keys.resize(g_bench_size[idx]);
+		for (key = 0U ; key < keys.size() ; ++key)
+			keys[key] = static_cast<int>(key * 2U);
+		std::random_shuffle(keys.begin(), keys.end());
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::map<int, t_uint>	ft_map;
+
+			for (key = 0U ; key < keys.size() ; ++key)
+				ft_map[keys[key]] = static_cast<t_uint>(key);
+			ft_duration = __time_iteration(ft_map, ft_sink);
+		}
+		{
+			std::map<int, t_uint>	std_map;
+
+			for (key = 0U ; key < keys.size() ; ++key)
+				std_map[keys[key]] = static_cast<t_uint>(key);
+			std_duration = __time_iteration(std_map, std_sink);
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static float	__ms(clock_t const duration)
+{
+	return 1000.0f * duration / CLOCKS_PER_SEC;
+}
+
+inline static int	__test_compact(void)
+{
+	std::vector<int>	keys;
+	std::vector<int>	queries;
+	clock_t				scattered_scan;
+	clock_t				scattered_finds;
+	clock_t				veb_finds;
+	clock_t				ft_duration;
+	clock_t				std_duration;
+	size_t				ft_sink;
+	size_t				std_sink;
+	size_t				idx;
+	size_t				key;
+
+	title(__func__);
+	std::cout << "scans of maps built in random order, ft compacted in key order, std as built\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		keys.resize(g_bench_size[idx]);
+		for (key = 0U ; key < keys.size() ; ++key)
+			keys[key] = static_cast<int>(key * 2U);
+		std::random_shuffle(keys.begin(), keys.end());
+		__random_keys(queries, g_query_count, g_bench_size[idx]);
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::map<int, t_uint>	ft_map;
+
+			for (key = 0U ; key < keys.size() ; ++key)
+				ft_map[keys[key]] = static_cast<t_uint>(key);
+			scattered_scan = __time_iteration(ft_map, ft_sink);
+			scattered_finds = __time_finds(ft_map, queries, ft_sink);
+			ft_map.compact(ft::van_emde_boas_layout);
+			veb_finds = __time_finds(ft_map, queries, ft_sink);
+			ft_map.compact(ft::in_order_layout);
+			ft_duration = __time_iteration(ft_map, ft_sink);
+		}
+		{
+			std::map<int, t_uint>	std_map;
+
+			for (key = 0U ; key < keys.size() ; ++key)
+				std_map[keys[key]] = static_cast<t_uint>(key);
+			std_duration = __time_iteration(std_map, std_sink);
+			__time_finds(std_map, queries, std_sink);
+			__time_finds(std_map, queries, std_sink);
+			__time_iteration(std_map, std_sink);
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		std::cout << "                     scattered -> compacted: scan " << __ms(scattered_scan) << " -> " << __ms(ft_duration)
+			<< " ms, " << queries.size() << " x find " << __ms(scattered_finds) << " -> " << __ms(veb_finds) << " ms (van Emde Boas)\n";
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_memory_per_entry(void)
+{
+	float	ft_bytes;
+	float	std_bytes;
+	size_t	idx;
+	bool	same;
+
+	title(__func__);
+	std::cout << "bytes requested from the allocator per map<int, t_uint> entry, "
+		<< sizeof(ft::RBNode<ft::pair<int const, t_uint> >) << " bytes per ft node\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		{
+			ft::map<int, t_uint, std::less<int>, counting_allocator<ft::pair<int const, t_uint> > >	ft_map;
+
+			g_allocated_bytes = 0U;
+			__fill(ft_map, g_bench_size[idx]);
+			ft_bytes = static_cast<float>(g_allocated_bytes) / g_bench_size[idx];
+			same = ft_map.size() == g_bench_size[idx];
+		}
+		{
+			std::map<int, t_uint, std::less<int>, counting_allocator<std::pair<int const, t_uint> > >	std_map;
+
+			g_allocated_bytes = 0U;
+			__fill(std_map, g_bench_size[idx]);
+			std_bytes = static_cast<float>(g_allocated_bytes) / g_bench_size[idx];
+		}
+		std::cout << "    " << std::setw(9) << g_bench_size[idx] << " keys : ft " << std::setw(6) << ft_bytes
+			<< " B, std " << std::setw(6) << std_bytes << " B, payload " << sizeof(ft::pair<int const, t_uint>) << " B\n";
+		if (!same)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Map>
+inline static clock_t	__time_erase(Map &map, t_uint const size, size_t &sink)
+{
+	typename Map::iterator	middle;
+	clock_t					start;
+	t_uint					idx;
+
+	for (middle = map.begin(), idx = 0U ; idx < size / 2U ; ++idx)
+		++middle;
+	start = clock();
+	map.erase(map.begin(), middle);
+	sink += map.size();
+	while (!map.empty())
+		map.erase(map.begin());
+	return clock() - start;
+}
+
+inline static int	__test_erase(void)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+
+	title(__func__);
+	std::cout << "erase(begin(), middle) then erase(begin()) until empty\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::map<int, t_uint>	ft_map;
+
+			__fill(ft_map, g_bench_size[idx]);
+			ft_duration = __time_erase(ft_map, g_bench_size[idx], ft_sink);
+		}
+		{
+			std::map<int, t_uint>	std_map;
+
+			__fill(std_map, g_bench_size[idx]);
+			std_duration = __time_erase(std_map, g_bench_size[idx], std_sink);
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_split_concat(void)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+	int		middle;
+
+	title(__func__);
+	std::cout << "move the upper half of the keys to another map and back\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		middle = static_cast<int>(g_bench_size[idx]);
+		{
+			ft::map<int, t_uint>	ft_map;
+			ft::map<int, t_uint>	ft_other;
+
+			__fill(ft_map, g_bench_size[idx]);
+			ft_duration = clock();
+			ft_map.split_at(middle, ft_other);
+			ft_sink = ft_map.size() + ft_other.size() * 2U;
+			ft_map.concat(ft_other);
+			ft_duration = clock() - ft_duration;
+			ft_sink += ft_map.size();
+		}
+		{
+			std::map<int, t_uint>	std_map;
+			std::map<int, t_uint>	std_other;
+
+			__fill(std_map, g_bench_size[idx]);
+			std_duration = clock();
+			std_other.insert(std_map.lower_bound(middle), std_map.end());
+			std_map.erase(std_map.lower_bound(middle), std_map.end());
+			std_sink = std_map.size() + std_other.size() * 2U;
+			std_map.insert(std_other.begin(), std_other.end());
+			std_other.clear();
+			std_duration = clock() - std_duration;
+			std_sink += std_map.size();
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Map>
+inline static void	__fill_multiples(Map &map, t_uint const size, t_uint const step)
+{
+	t_uint	idx;
+
+	for (idx = 0U ; idx < size ; ++idx)
+		map[static_cast<int>(idx * step)] = idx;
+}
+
+inline static int	__test_set_algebra(void)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+
+	title(__func__);
+	std::cout << "union of the multiples of 2 and 3, then intersection with the multiples of 3\n";
+	for (idx = 0U ; idx < g_bench_size_size ; ++idx)
+	{
+		{
+			ft::map<int, t_uint>	ft_map;
+			ft::map<int, t_uint>	ft_other;
+
+			__fill_multiples(ft_map, g_bench_size[idx], 2U);
+			__fill_multiples(ft_other, g_bench_size[idx], 3U);
+			ft_duration = clock();
+			ft_map.merge_from(ft_other);
+			ft_sink = ft_map.size();
+			ft_map.intersect_with(ft_other);
+			ft_duration = clock() - ft_duration;
+			ft_sink += ft_map.size() * 2U;
+		}
+		{
+			std::map<int, t_uint>	std_map;
+			std::map<int, t_uint>	std_other;
+			std::map<int, t_uint>	std_result;
+
+			__fill_multiples(std_map, g_bench_size[idx], 2U);
+			__fill_multiples(std_other, g_bench_size[idx], 3U);
+			std_duration = clock();
+			std_map.insert(std_other.begin(), std_other.end());
+			std_sink = std_map.size();
+			for (std::map<int, t_uint>::const_iterator it = std_other.begin() ; it != std_other.end() ; ++it)
+				if (std_map.count(it->first))
+					std_result.insert(*std_map.find(it->first));
+			std_map.swap(std_result);
+			std_duration = clock() - std_duration;
+			std_sink += std_map.size() * 2U;
+		}
+		__report(g_bench_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_interval_overlap(void)
+{
+	std::vector<std::pair<int, int> >			intervals;
+	std::vector<int>							windows;
+	ft::interval_map<int, t_uint>::iterator		it;
+	clock_t										tree_duration;
+	clock_t										scan_duration;
+	size_t										tree_sink;
+	size_t										scan_sink;
+	size_t										idx;
+	size_t										query;
+	size_t										pos;
+	int											low;
+
+	title(__func__);
+	std::cout << g_window_count << " x count the intervals overlapping a random window, interval_map against a linear scan\n";
+	for (idx = 0U ; idx < g_interval_size_size ; ++idx)
+	{
+		ft::interval_map<int, t_uint>	ft_map;
+
+		for (query = 0U ; query < g_interval_size[idx] ; ++query)
+		{
+			low = static_cast<int>(static_cast<t_uint>(rand()) % (g_interval_size[idx] * 16U));
+			ft_map.insert(ft::make_pair(ft::make_pair(low, low + 1 + rand() % static_cast<int>(g_window_length)), static_cast<t_uint>(query)));
+		}
+		intervals.clear();
+		for (it = ft_map.begin() ; it != ft_map.end() ; ++it)
+			intervals.push_back(std::make_pair(it->first.first, it->first.second));
+		__random_keys(windows, g_window_count, g_interval_size[idx] * 8U);
+
+		tree_sink = 0U;
+		tree_duration = clock();
+		for (query = 0U ; query < windows.size() ; ++query)
+			tree_sink += ft_map.count_overlaps(windows[query], windows[query] + static_cast<int>(g_window_length));
+		tree_duration = clock() - tree_duration;
+
+		scan_sink = 0U;
+		scan_duration = clock();
+		for (query = 0U ; query < windows.size() ; ++query)
+			for (pos = 0U ; pos < intervals.size() ; ++pos)
+				scan_sink += intervals[pos].first < windows[query] + static_cast<int>(g_window_length) && windows[query] < intervals[pos].second;
+		scan_duration = clock() - scan_duration;
+
+		std::cout << "    " << std::setw(9) << g_interval_size[idx] << " intervals : interval_map " << std::setw(10) << 1000.0f * tree_duration / CLOCKS_PER_SEC
+			<< " ms, linear scan " << std::setw(10) << 1000.0f * scan_duration / CLOCKS_PER_SEC << " ms, " << tree_sink << " overlaps\n";
+		if (tree_sink != scan_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+int	bench_map(void)
+{
+	t_fct const	benchs[] = {
+		__test_bounds,
+		__test_find_many,
+		__test_hinted_ingest,
+		__test_sorted_construction,
+		__test_copy,
+		__test_churn_allocations,
+		__test_node_transfer,
+		__test_iteration,
+		__test_reverse_iteration,
+		__test_iteration_shuffled,
+		__test_compact,
+		__test_memory_per_entry,
+		__test_erase,
+		__test_split_concat,
+		__test_set_algebra,
+		__test_interval_overlap,
+		NULL
+	};
+	t_uint		koCount;
+	t_uint		idx;
+
+	std::cerr << LIGHT_BLUE_FG;
+	std::cout << "###################################################" << '\n';
+	std::cout << "##                 MAP BENCHMARK                 ##" << '\n';
+	std::cout << "###################################################" << '\n';
+	std::cerr << RESET;
+
+	for (koCount = 0U, idx = 0U ; benchs[idx] ; ++idx)
+	{
+		if (benchs[idx]() == KO)
+		{
+			std::cerr << RED_FG;
+			std::cout << "    [KO] results differ from std::map" << '\n';
+			std::cerr << RESET;
+			++koCount;
+		}
+	}
+	std::cout << '\n';
+	return koCount;
+}
@@ -0,0 +1,483 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_vector.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: chduong <chduong@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/03/06 09:48:12 by chduong           #+#    #+#             */
+/*   Updated: 2023/03/06 09:48:12 by chduong          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "colors.hpp"
+#include "e_ret.hpp"
+#include "headers.hpp"
+#include "tester.hpp"
+#include "t_int.hpp"
+#include VECTOR_HEADER
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+static t_uint const	g_growth_size[] = {
+	1000U,
+	1000000U,
+	10000000U,
+};
+static size_t const	g_growth_size_size = sizeof(g_growth_size) / sizeof(*g_growth_size);
+
+static t_uint const	g_erase_size[] = {
+	1000U,
+	100000U,
+	1000000U,
+};
+static size_t const	g_erase_size_size = sizeof(g_erase_size) / sizeof(*g_erase_size);
+
+static t_uint const	g_erase_count = 100U;
+
+static t_uint const	g_insert_count = 100U;
+
+static t_uint const	g_string_length = 32U;
+
+/**
+ * @brief	Plain 64 bytes structure.
+ */
+struct pod64
+{
+	t_uint	words[16];
+};
+
+/**
+ * @brief	String owning its characters on the heap, which can be moved bytewise.
+ * 			Only heap_string<true> tells ft::vector so.
+ */
+template <bool Relocatable>
+class heap_string
+{
+	private:
+		char	*_chars;
+		size_t	_length;
+
+	public:
+		heap_string(void) : _chars(NULL), _length(0U) {}
+		explicit heap_string(std::string const &src) : _chars(new char[src.size()]), _length(src.size()) { memcpy(_chars, src.data(), _length); }
+		heap_string(heap_string const &src) : _chars(new char[src._length]), _length(src._length) { memcpy(_chars, src._chars, _length); }
+		~heap_string(void) { delete[] _chars; }
+
+		heap_string	&operator=(heap_string const &rhs)
+		{
+			heap_string	tmp(rhs);
+
+			std::swap(_chars, tmp._chars);
+			std::swap(_length, tmp._length);
+			return *this;
+		}
+
+		size_t	size(void) const { return _length; }
+};
+
+namespace ft
+{
+	template <>
+	struct is_trivially_relocatable<heap_string<true> > : public true_type {};
+}
+
+/**
+ * @brief	Display one line of a benchmark: the duration of both implementations
+ * 			for a given container size, and how they compare.
+ */
+inline static void	__report(t_uint const size, clock_t const ft_duration, clock_t const std_duration)
+{
+	float const	ft_ms = 1000.0f * ft_duration / CLOCKS_PER_SEC;
+	float const	std_ms = 1000.0f * std_duration / CLOCKS_PER_SEC;
+	float const	ratio = static_cast<float>(ft_duration + !ft_duration) / static_cast<float>(std_duration + !std_duration);
+
+	std::cout << "    " << std::setw(9) << size << " elems: ft " << std::setw(10) << ft_ms << " ms, std " << std::setw(10) << std_ms << " ms ";
+	if (ratio < 1.0f)
+	{
+		std::cerr << GREEN_FG;
+		std::cout << '(' << 1.0f / ratio << "x faster)";
+	}
+	else
+	{
+		std::cerr << (ratio < 2.0f ? GREEN_FG : (ratio < 10.0f ? YELLOW_FG : RED_FG));
+		std::cout << '(' << ratio << "x slower)";
+	}
+	std::cerr << RESET;
+	std::cout << '\n';
+}
+
+inline static std::string	__value(t_uint const idx, std::string const &)
+{
+	return std::string(g_string_length, static_cast<char>('a' + idx % 26U));
+}
+
+inline static t_uint	__value(t_uint const idx, t_uint const &)
+{
+	return idx;
+}
+
+inline static pod64	__value(t_uint const idx, pod64 const &)
+{
+	pod64	value;
+	t_uint	word;
+
+	for (word = 0U ; word < 16U ; ++word)
+		value.words[word] = idx + word;
+	return value;
+}
+
+inline static size_t	__sum(t_uint const &value)
+{
+	return value;
+}
+
+inline static size_t	__sum(pod64 const &value)
+{
+	return value.words[0] + value.words[15];
+}
+
+inline static size_t	__sum(std::string const &value)
+{
+	return value[0];
+}
+
+template <typename Vector>
+inline static clock_t	__time_growth(Vector &vec, t_uint const size, size_t &sink)
+{
+	typename Vector::value_type const	sample = typename Vector::value_type();
+	clock_t								start;
+	t_uint								idx;
+
+	start = clock();
+	for (idx = 0U ; idx < size ; ++idx)
+		vec.push_back(__value(idx, sample));
+	sink += vec.size() + __sum(vec.back());
+	return clock() - start;
+}
+
+template <typename T>
+inline static int	__test_growth(char const *const name)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+
+	title(name);
+	std::cout << "push_back() from empty, reallocating as it grows\n";
+	for (idx = 0U ; idx < g_growth_size_size ; ++idx)
+	{
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::vector<T>	ft_vec;
+
+			ft_duration = __time_growth(ft_vec, g_growth_size[idx], ft_sink);
+		}
+		{
+			std::vector<T>	std_vec;
+
+			std_duration = __time_growth(std_vec, g_growth_size[idx], std_sink);
+		}
+		__report(g_growth_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Vector>
+inline static clock_t	__time_erase(Vector &vec, t_uint const size, size_t &sink)
+{
+	typename Vector::value_type const	sample = typename Vector::value_type();
+	clock_t								start;
+	t_uint								idx;
+
+	for (idx = 0U ; idx < size ; ++idx)
+		vec.push_back(__value(idx, sample));
+	start = clock();
+	for (idx = 0U ; idx < g_erase_count && vec.size() > 2U ; ++idx)
+	{
+		vec.erase(vec.begin());
+		vec.erase(vec.begin() + vec.size() / 2U, vec.begin() + vec.size() / 2U + 2U);
+	}
+	sink += vec.size() + __sum(vec.front()) + __sum(vec[vec.size() / 2U]);
+	return clock() - start;
+}
+
+template <typename T>
+inline static int	__test_erase(char const *const name)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+
+	title(name);
+	std::cout << g_erase_count << " x (erase(begin()) + erase of 2 elements in the middle)\n";
+	for (idx = 0U ; idx < g_erase_size_size ; ++idx)
+	{
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::vector<T>	ft_vec;
+
+			ft_duration = __time_erase(ft_vec, g_erase_size[idx], ft_sink);
+		}
+		{
+			std::vector<T>	std_vec;
+
+			std_duration = __time_erase(std_vec, g_erase_size[idx], std_sink);
+		}
+		__report(g_erase_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Vector>
+inline static clock_t	__time_insert(Vector &vec, t_uint const size, size_t &sink)
+{
+	typename Vector::value_type const	sample = typename Vector::value_type();
+	std::list<typename Vector::value_type>	range;
+	clock_t								start;
+	t_uint								idx;
+
+	for (idx = 0U ; idx < size ; ++idx)
+		vec.push_back(__value(idx, sample));
+	for (idx = 0U ; idx < 8U ; ++idx)
+		range.push_back(__value(idx, sample));
+	start = clock();
+	for (idx = 0U ; idx < g_insert_count ; ++idx)
+	{
+		vec.insert(vec.begin() + vec.size() / 2U, 8U, __value(idx, sample));
+		vec.insert(vec.begin() + vec.size() / 3U, range.begin(), range.end());
+	}
+	sink += vec.size() + __sum(vec[vec.size() / 2U]) + __sum(vec[vec.size() / 3U]);
+	return clock() - start;
+}
+
+template <typename T>
+inline static int	__test_insert(char const *const name)
+{
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+
+	title(name);
+	std::cout << g_insert_count << " x (insert of 8 copies in the middle + insert of a list of 8 at a third)\n";
+	for (idx = 0U ; idx < g_erase_size_size ; ++idx)
+	{
+		ft_sink = 0U;
+		std_sink = 0U;
+		{
+			ft::vector<T>	ft_vec;
+
+			ft_duration = __time_insert(ft_vec, g_erase_size[idx], ft_sink);
+		}
+		{
+			std::vector<T>	std_vec;
+
+			std_duration = __time_insert(std_vec, g_erase_size[idx], std_sink);
+		}
+		__report(g_erase_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+template <typename Vector, typename Source>
+inline static clock_t	__time_construction(Source const &src, size_t &sink)
+{
+	clock_t	start;
+
+	start = clock();
+	{
+		Vector	from_range(src.begin(), src.end());
+		Vector	copy(from_range);
+		Vector	assigned;
+
+		assigned.assign(src.begin(), src.end());
+		assigned = copy;
+		sink += from_range.size() + copy.size() + assigned.size() + from_range.back() + copy.back();
+	}
+	return clock() - start;
+}
+
+template <typename Source>
+inline static int	__test_construction(char const *const name)
+{
+	Source	src;
+	clock_t	ft_duration;
+	clock_t	std_duration;
+	size_t	ft_sink;
+	size_t	std_sink;
+	size_t	idx;
+	t_uint	elem;
+
+	title(name);
+	std::cout << "vector(first, last), vector(const vector &), assign(first, last), operator=\n";
+	for (idx = 0U ; idx < g_growth_size_size ; ++idx)
+	{
+		src.clear();
+		for (elem = 0U ; elem < g_growth_size[idx] ; ++elem)
+			src.push_back(elem);
+		ft_sink = 0U;
+		std_sink = 0U;
+		ft_duration = __time_construction<ft::vector<t_uint> >(src, ft_sink);
+		std_duration = __time_construction<std::vector<t_uint> >(src, std_sink);
+		__report(g_growth_size[idx], ft_duration, std_duration);
+		if (ft_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_construction_from_vector(void)
+{
+	return __test_construction<std::vector<t_uint> >(__func__);
+}
+
+inline static int	__test_construction_from_list(void)
+{
+	return __test_construction<std::list<t_uint> >(__func__);
+}
+
+template <typename String>
+inline static clock_t	__time_string_growth(std::vector<std::string> const &src, size_t &sink)
+{
+	ft::vector<String>	vec;
+	clock_t				start;
+	size_t				idx;
+
+	start = clock();
+	for (idx = 0U ; idx < src.size() ; ++idx)
+		vec.push_back(String(src[idx]));
+	sink += vec.size() + vec.back().size();
+	return clock() - start;
+}
+
+inline static int	__test_growth_strings(void)
+{
+	std::vector<std::string>	src;
+	clock_t						relocated;
+	clock_t						copied;
+	clock_t						std_duration;
+	size_t						relocated_sink;
+	size_t						copied_sink;
+	size_t						std_sink;
+	size_t						idx;
+	size_t						elem;
+
+	title(__func__);
+	std::cout << "push_back() of " << g_string_length << " characters strings, ft relocating them bytewise as it grows\n";
+	for (idx = 0U ; idx < g_erase_size_size ; ++idx)
+	{
+		src.assign(g_erase_size[idx], std::string(g_string_length, '*'));
+		relocated_sink = 0U;
+		copied_sink = 0U;
+		std_sink = 0U;
+		relocated = __time_string_growth<heap_string<true> >(src, relocated_sink);
+		copied = __time_string_growth<heap_string<false> >(src, copied_sink);
+		{
+			std::vector<heap_string<false> >	std_vec;
+
+			std_duration = clock();
+			for (elem = 0U ; elem < src.size() ; ++elem)
+				std_vec.push_back(heap_string<false>(src[elem]));
+			std_sink += std_vec.size() + std_vec.back().size();
+			std_duration = clock() - std_duration;
+		}
+		__report(g_erase_size[idx], relocated, std_duration);
+		std::cout << "                     without is_trivially_relocatable: ft " << 1000.0f * copied / CLOCKS_PER_SEC << " ms\n";
+		if (relocated_sink != std_sink || copied_sink != std_sink)
+			return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_growth_int(void)
+{
+	return __test_growth<t_uint>(__func__);
+}
+
+inline static int	__test_growth_pod64(void)
+{
+	return __test_growth<pod64>(__func__);
+}
+
+inline static int	__test_insert_int(void)
+{
+	return __test_insert<t_uint>(__func__);
+}
+
+inline static int	__test_insert_pod64(void)
+{
+	return __test_insert<pod64>(__func__);
+}
+
+inline static int	__test_erase_int(void)
+{
+	return __test_erase<t_uint>(__func__);
+}
+
+inline static int	__test_erase_pod64(void)
+{
+	return __test_erase<pod64>(__func__);
+}
+
+inline static int	__test_erase_strings(void)
+{
+	return __test_erase<std::string>(__func__);
+}
+
+int	bench_vector(void)
+{
+	t_fct const	benchs[] = {
+		__test_growth_int,
+		__test_growth_pod64,
+		__test_growth_strings,
+		__test_construction_from_vector,
+		__test_construction_from_list,
+		__test_insert_int,
+		__test_insert_pod64,
+		__test_erase_int,
+		__test_erase_pod64,
+		__test_erase_strings,
+		NULL
+	};
+	t_uint		koCount;
+	t_uint		idx;
+
+	std::cerr << LIGHT_BLUE_FG;
+	std::cout << "###################################################" << '\n';
+	std::cout << "##               VECTOR BENCHMARK                ##" << '\n';
+	std::cout << "###################################################" << '\n';
+	std::cerr << RESET;
+
+	for (koCount = 0U, idx = 0U ; benchs[idx] ; ++idx)
+	{
+		if (benchs[idx]() == KO)
+		{
+			std::cerr << RED_FG;
+			std::cout << "    [KO] results differ from std::vector" << '\n';
+			std::cerr << RESET;
+			++koCount;
+		}
+	}
+	std::cout << '\n';
+	return koCount;
+}
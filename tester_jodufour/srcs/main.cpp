@@ -12,6 +12,7 @@
 
 #include "tester.hpp"
 #include "t_int.hpp"
+#include "values.hpp"
 #include <cstdlib>
 #include <ctime>
 #include <iomanip>
@@ -23,6 +24,12 @@ time_t					g_ft_duration;
 time_t					g_std_duration;
 std::multiset<float>	g_ratio;
 
+int						__throwing_copy::copies_left = -1;
+int						__throwing_copy::alive = 0;
+t_uint					__counted::constructions = 0U;
+t_uint					__counted::copies = 0U;
+t_uint					__counted::assignments = 0U;
+
 static void	__init(void) __attribute__((constructor));
 
 static void	__init(void)
@@ -42,7 +49,9 @@ int	main(int const ac, char const *const *av)
 		{std::string("vector"), test_vector, true},
 		{std::string("stack"), test_stack, true},
 		{std::string("map"), test_map, true},
-		// {std::string("set"), test_set, false},
+		{std::string("set"), test_set, true},
+		{std::string("bench_map"), bench_map, false},
+		{std::string("bench_vector"), bench_vector, false},
 		{std::string(""), NULL, false}
 	};
 	std::string		test_name;
@@ -18,11 +18,13 @@
 #include "t_int.hpp"
 #include EQUAL_HEADER
 #include LEXICOGRAPHICAL_COMPARE_HEADER
+#include SET_OPERATIONS_HEADER
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <vector>
 
 static int const			g_int0[] = {
@@ -1129,11 +1131,73 @@ inline static int	__test_lexicographical_compare(void)
 	return EXIT_SUCCESS;
 }
 
+inline static int	__test_set_operations(void)
+{
+	std::vector<int>	ft_out;
+	std::vector<int>	std_out;
+
+	title(__func__);
+	try
+	{
+		// Default comparison, the arrays share all of their elements but the last one
+		{
+			int const *const	first0 = &g_int0[0];
+			int const *const	last0 = &g_int0[g_int0_size];
+			int const *const	first1 = &g_int1[0];
+			int const *const	last1 = &g_int1[g_int1_size];
+
+			ft::set_union(first0, last0, first1, last1, std::back_inserter(ft_out));
+			std::set_union(first0, last0, first1, last1, std::back_inserter(std_out));
+			ft::set_intersection(first0, last0, first1, last1, std::back_inserter(ft_out));
+			std::set_intersection(first0, last0, first1, last1, std::back_inserter(std_out));
+			ft::set_difference(first0, last0, first1, last1, std::back_inserter(ft_out));
+			std::set_difference(first0, last0, first1, last1, std::back_inserter(std_out));
+			ft::set_symmetric_difference(first0, last0, first1, last1, std::back_inserter(ft_out));
+			std::set_symmetric_difference(first0, last0, first1, last1, std::back_inserter(std_out));
+			if (ft_out != std_out ||
+				ft::includes(first0, last0, first1, last1) != std::includes(first0, last0, first1, last1) ||
+				ft::includes(first0, last0, first0 + 3, last0 - 3) != std::includes(first0, last0, first0 + 3, last0 - 3))
+				return EXIT_FAILURE;
+		}
+		// Custom comparison, with input iterators and duplicate elements
+		{
+			int const					array0[] = {9, 7, 7, 7, 4, 2, 2, 0};
+			int const					array1[] = {8, 7, 7, 4, 4, 3, 2};
+			std::greater<int> const		cmp;
+			tester::input_iterator_restrictor<int const *> const	first0(&array0[0]);
+			tester::input_iterator_restrictor<int const *> const	last0(&array0[sizeof(array0) / sizeof(*array0)]);
+			tester::input_iterator_restrictor<int const *> const	first1(&array1[0]);
+			tester::input_iterator_restrictor<int const *> const	last1(&array1[sizeof(array1) / sizeof(*array1)]);
+
+			ft_out.clear();
+			std_out.clear();
+			ft::set_union(first0, last0, first1, last1, std::back_inserter(ft_out), cmp);
+			std::set_union(first0, last0, first1, last1, std::back_inserter(std_out), cmp);
+			ft::set_intersection(first0, last0, first1, last1, std::back_inserter(ft_out), cmp);
+			std::set_intersection(first0, last0, first1, last1, std::back_inserter(std_out), cmp);
+			ft::set_difference(first0, last0, first1, last1, std::back_inserter(ft_out), cmp);
+			std::set_difference(first0, last0, first1, last1, std::back_inserter(std_out), cmp);
+			ft::set_symmetric_difference(first0, last0, first1, last1, std::back_inserter(ft_out), cmp);
+			std::set_symmetric_difference(first0, last0, first1, last1, std::back_inserter(std_out), cmp);
+			if (ft_out != std_out ||
+				ft::includes(first0, last0, first1, last1, cmp) != std::includes(first0, last0, first1, last1, cmp))
+				return EXIT_FAILURE;
+		}
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
 int	test_algorithm(void)
 {
 	t_fct const				tests[] = {
 		__test_equal,
 		__test_lexicographical_compare,
+		__test_set_operations,
 		NULL
 	};
 	
@@ -19,7 +19,9 @@
 #include "iterator/restrictor/random_access_iterator_restrictor.tpp"
 #include "tester.hpp"
 #include "e_ret.hpp"
+#include "values.hpp"
 #include MAP_HEADER
+#include INTERVAL_MAP_HEADER
 #include <algorithm>
 #include <cstring>
 #include <ctime>
@@ -27,6 +29,8 @@
 #include <iterator>
 #include <list>
 #include <map>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 template <typename T0, typename T1>
@@ -257,6 +261,69 @@ inline static int	__test_constructor_copy(void)
 	return ret;
 }
 
+inline static int	__test_constructor_range_sorted(void)
+{
+	t_uint	size;
+	t_uint	idx;
+
+	title(__func__);
+	try
+	{
+		for (size = 0U ; size < 300U ; size += 7U)
+		{
+			std::vector<ft::pair<int, t_uint> >		ft_vec;
+			std::vector<std::pair<int, t_uint> >	std_vec;
+
+			// Sorted keys, with every fifth one duplicated
+			for (idx = 0U ; idx < size ; ++idx)
+			{
+				ft_vec.push_back(ft::pair<int, t_uint>(static_cast<int>(idx * 3U), idx));
+				std_vec.push_back(std::pair<int, t_uint>(static_cast<int>(idx * 3U), idx));
+				if (!(idx % 5U))
+				{
+					ft_vec.push_back(ft::pair<int, t_uint>(static_cast<int>(idx * 3U), 42U));
+					std_vec.push_back(std::pair<int, t_uint>(static_cast<int>(idx * 3U), 42U));
+				}
+			}
+
+			g_start = clock();
+			ft::map<int, t_uint>	ft_map(ft_vec.begin(), ft_vec.end());
+			g_ft_duration = clock() - g_start;
+			g_ft_duration += !g_ft_duration;
+
+			g_start = clock();
+			std::map<int, t_uint>	std_map(std_vec.begin(), std_vec.end());
+			g_std_duration = clock() - g_start;
+			g_std_duration += !g_std_duration;
+
+			g_ratio.insert(static_cast<float>(g_ft_duration) / static_cast<float>(g_std_duration));
+
+			if (ft_map.size() != std_map.size() ||
+				!std::equal(ft_map.begin(), ft_map.end(), std_map.begin(), __cmp<int const, t_uint>))
+				return KO;
+
+			// The built tree must stay a valid red-black tree through later modifications
+			for (idx = 0U ; idx < size ; idx += 3U)
+			{
+				ft_map.erase(static_cast<int>(idx * 3U));
+				std_map.erase(static_cast<int>(idx * 3U));
+				ft_map.insert(ft::pair<int, t_uint>(static_cast<int>(idx * 3U + 1U), idx));
+				std_map.insert(std::pair<int, t_uint>(static_cast<int>(idx * 3U + 1U), idx));
+			}
+			if (ft_map.size() != std_map.size() ||
+				!std::equal(ft_map.begin(), ft_map.end(), std_map.begin(), __cmp<int const, t_uint>) ||
+				!std::equal(ft_map.rbegin(), ft_map.rend(), std_map.rbegin(), __cmp<int const, t_uint>))
+				return KO;
+		}
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
 inline static int	__test_default_template_type_Compare(void)
 {
 	title(__func__);
@@ -1567,6 +1634,55 @@ inline static int	__test_type_const_reverse_iterator(void)
 	return ret;
 }
 
+inline static int	__test_type_reverse_iterator_base(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, int>							ft_map;
+		std::map<int, int>							std_map;
+		ft::map<int, int>::reverse_iterator			ft_rit;
+		std::map<int, int>::reverse_iterator		std_rit;
+		ft::map<int, int>::const_reverse_iterator	ft_crit;
+
+		if (ft_map.rbegin() != ft_map.rend() || ft_map.rend().base() != ft_map.begin() ||
+			ft::map<int, int>::reverse_iterator(ft_map.begin()) != ft_map.rend())
+			return KO;
+		for (key = 0 ; key < 64 ; ++key)
+		{
+			ft_map[key * 3 % 64] = key;
+			std_map[key * 3 % 64] = key;
+
+			// every element is the one before base(), and a reverse_iterator built from base() finds it again
+			for (ft_rit = ft_map.rbegin(), std_rit = std_map.rbegin() ; std_rit != std_map.rend() ; ++ft_rit, ++std_rit)
+			{
+				if (ft_rit == ft_map.rend() || ft_rit->first != std_rit->first ||
+					(ft_rit.base() == ft_map.end()) != (std_rit.base() == std_map.end()) ||
+					(std_rit.base() != std_map.end() && ft_rit.base()->first != std_rit.base()->first) ||
+					ft::map<int, int>::reverse_iterator(ft_rit.base()) != ft_rit)
+					return KO;
+			}
+			if (ft_rit != ft_map.rend() || ft_rit.base() != ft_map.begin())
+				return KO;
+		}
+
+		// back from rend() to rbegin()
+		for (ft_crit = ft_map.rend(), key = 0 ; ft_crit != ft_map.rbegin() ; ++key)
+			if ((--ft_crit)->first != key)
+				return KO;
+		if (key != 64 || ft_crit->first != 63)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
 inline static int	__test_function_insert_range(void)
 {
 	t_uint	idx;
@@ -1609,6 +1725,105 @@ inline static int	__test_function_insert_range(void)
 		std::cerr << "Exception: " << e.what() << '\n';
 		return KO;
 	}
+	try
+	{
+		ft::map<int, __throwing_copy>	ft_src;
+		ft::map<int, __throwing_copy>	ft_map;
+		int								key;
+		int								alive;
+
+		for (key = 0 ; key < 100 ; ++key)
+			ft_src.insert(ft::make_pair(key, __throwing_copy(key)));
+
+		// a copy failing halfway through a sorted build leaves the map empty, and every value built is destroyed
+		alive = __throwing_copy::alive;
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft_map.insert(ft_src.begin(), ft_src.end());
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		__throwing_copy::copies_left = -1;
+		if (!ft_map.empty() || ft_map.begin() != ft_map.end() || __throwing_copy::alive != alive)
+			return KO;
+		ft_map.insert(ft_src.begin(), ft_src.end());
+		if (ft_map.size() != 100U || ft_map.begin()->second.value != 0 || ft_map.rbegin()->second.value != 99)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_copy_throw(void)
+{
+	int	key;
+	int	alive;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, __throwing_copy>	ft_src;
+		ft::map<int, __throwing_copy>	ft_small;
+		ft::map<int, __throwing_copy>	ft_big;
+
+		for (key = 0 ; key < 100 ; ++key)
+			ft_src.insert(ft::make_pair(key, __throwing_copy(key)));
+		for (key = 0 ; key < 30 ; ++key)
+			ft_small.insert(ft::make_pair(-key, __throwing_copy(-key)));
+		for (key = 0 ; key < 300 ; ++key)
+			ft_big.insert(ft::make_pair(-key, __throwing_copy(-key)));
+
+		// a copy constructor failing halfway through destroys every value it built
+		alive = __throwing_copy::alive;
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft::map<int, __throwing_copy>	ft_copy(ft_src);
+
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		if (__throwing_copy::alive != alive)
+			return KO;
+
+		// a failing assignment leaves the map empty, from recycled nodes or new ones
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft_small = ft_src;
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft_big = ft_src;
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		__throwing_copy::copies_left = -1;
+		if (__throwing_copy::alive != alive - 330 ||
+			!ft_small.empty() || ft_small.begin() != ft_small.end() ||
+			!ft_big.empty() || ft_big.begin() != ft_big.end())
+			return KO;
+
+		// both maps keep working
+		ft_small = ft_src;
+		ft_big[1000] = __throwing_copy(1000);
+		if (ft_small.size() != 100U || ft_small.begin()->second.value != 0 || ft_small.rbegin()->second.value != 99 ||
+			ft_big.size() != 1U || ft_big.begin()->second.value != 1000)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
 	return IMP_OK;
 }
 
@@ -1754,6 +1969,698 @@ inline static int	__test_function_insert_single_hint(void)
 	return IMP_OK;
 }
 
+inline static int	__test_function_emplace_copies(void)
+{
+	title(__func__);
+	try
+	{
+		ft::map<int, __counted>						ft_map;
+		ft::pair<int const, __counted> const		elem(1, __counted(1));
+		__counted const								value(4);
+
+		// Each insertion constructs its element once, straight in the node
+		__counted::reset();
+		if (!ft_map.insert(elem).second || __counted::constructions != 1U)
+			return KO;
+		__counted::reset();
+		ft_map[2];
+		if (__counted::constructions != 1U || __counted::copies)
+			return KO;
+		__counted::reset();
+		if (!ft_map.try_emplace(3, 3).second || __counted::constructions != 1U || __counted::copies)
+			return KO;
+		__counted::reset();
+		if (!ft_map.emplace(4, value).second || __counted::constructions != 1U)
+			return KO;
+		__counted::reset();
+		if (!ft_map.insert_or_assign(5, value).second || __counted::constructions != 1U || __counted::assignments)
+			return KO;
+
+		// Nothing is constructed for a key already present
+		__counted::reset();
+		if (ft_map.insert(elem).second || ft_map.try_emplace(3, 42).second || __counted::constructions)
+			return KO;
+		ft_map[2];
+		if (ft_map.insert_or_assign(5, __counted(42)).second || __counted::constructions != 1U || __counted::assignments != 1U)
+			return KO;
+
+		if (ft_map.size() != 5U || ft_map[1].value != 1 || ft_map[2].value || ft_map[3].value != 3 || ft_map[4].value != 4 || ft_map[5].value != 42)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_transparent_lookup(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::map<__counted, int, __counted_less>			ft_map;
+		ft::map<__counted, int, __counted_less> const	&ft_cmap = ft_map;
+
+		for (key = 0 ; key < 100 ; key += 2)
+			ft_map.insert(ft::make_pair(__counted(key), key));
+
+		// __counted has no operator==, and looking it up by int must not build any
+		__counted::reset();
+		for (key = -1 ; key < 101 ; ++key)
+		{
+			if ((ft_map.find(key) == ft_map.end()) != (key % 2 != 0 || key < 0 || key >= 100) ||
+				(ft_cmap.find(key) != ft_cmap.end() && ft_cmap.find(key)->second != key) ||
+				ft_map.count(key) != static_cast<size_t>(key % 2 == 0 && key >= 0 && key < 100) ||
+				(ft_map.lower_bound(key) != ft_map.end() && ft_map.lower_bound(key)->first.value != key + (key % 2 != 0)) ||
+				(ft_cmap.upper_bound(key) != ft_cmap.end() && ft_cmap.upper_bound(key)->first.value != key + 1 + (key % 2 == 0)) ||
+				ft_map.equal_range(key).second != ft_map.upper_bound(key))
+				return KO;
+		}
+		if (ft_map.erase(42) != 1U || ft_map.erase(43) != 0U || ft_map.count(42) || ft_map.size() != 49U)
+			return KO;
+		if (__counted::constructions || __counted::copies)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+#ifdef FT_ORDER_STATISTICS
+inline static int	__test_function_order_statistics(void)
+{
+	int	key;
+	int	idx;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, int>					ft_map;
+		ft::map<int, int> const				&ft_cmap = ft_map;
+		ft::map<int, int>::iterator			ft_it;
+		ft::map<int, int>::const_iterator	ft_cit;
+
+		for (key = 0 ; key < 1000 ; key += 3)
+			ft_map[key] = key;
+		for (key = 0 ; key < 1000 ; key += 6)
+			ft_map.erase(key);
+		// keys left are 3, 9, 15 ... 999: key 6 * idx + 3 sits at position idx
+		for (idx = 0, ft_it = ft_map.begin() ; ft_it != ft_map.end() ; ++idx, ++ft_it)
+		{
+			ft_cit = ft_cmap.nth(idx);
+			if (ft_map.nth(idx) != ft_it || ft_cit->first != 6 * idx + 3 ||
+				ft_map.rank(6 * idx + 3) != static_cast<size_t>(idx) ||
+				ft_map.rank(6 * idx + 4) != static_cast<size_t>(idx + 1) ||
+				ft::distance(ft_map.begin(), ft_it) != idx ||
+				ft::distance(ft_it, ft_map.end()) != static_cast<ptrdiff_t>(ft_map.size()) - idx)
+				return KO;
+		}
+		if (idx != 167 || ft_map.nth(ft_map.size()) != ft_map.end() ||
+			ft_map.count_range(0, 1000) != 167U || ft_map.count_range(9, 21) != 2U ||
+			ft_map.count_range(9, 22) != 3U || ft_map.count_range(21, 9) != 0U)
+			return KO;
+		{
+			using namespace std;
+
+			// found next to std::distance, and chosen over it
+			if (distance(ft_map.begin(), ft_map.end()) != 167 || distance(ft_cmap.begin(), ft_cmap.end()) != 167)
+				return KO;
+		}
+		ft_map.erase(ft_map.nth(10), ft_map.nth(150));
+		if (ft_map.size() != 27U || ft_map.nth(10)->first != 6 * 150 + 3 || ft_map.rank(1000) != 27U)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+#endif
+
+#if defined(FT_COMPACT_NODES) || defined(FT_INDEX_NODES) || defined(FT_THREADED_NODES)
+// parent, left and right, and the in-order links when there are some
+# ifdef FT_THREADED_NODES
+static size_t const	g_node_links = 5U;
+# else
+static size_t const	g_node_links = 3U;
+# endif
+
+// walks both maps forward and backward
+template <typename K, typename V>
+inline static bool	__same_content(ft::map<K, V> const &ft_map, std::map<K, V> const &std_map)
+{
+	typename ft::map<K, V>::const_iterator			ft_it;
+	typename ft::map<K, V>::const_reverse_iterator	ft_rit;
+	typename std::map<K, V>::const_iterator			std_it;
+	typename std::map<K, V>::const_reverse_iterator	std_rit;
+
+	if (ft_map.size() != std_map.size())
+		return false;
+	for (ft_it = ft_map.begin(), std_it = std_map.begin() ; std_it != std_map.end() ; ++ft_it, ++std_it)
+		if (ft_it == ft_map.end() || ft_it->first != std_it->first || ft_it->second != std_it->second)
+			return false;
+	if (ft_it != ft_map.end())
+		return false;
+	for (ft_rit = ft_map.rbegin(), std_rit = std_map.rbegin() ; std_rit != std_map.rend() ; ++ft_rit, ++std_rit)
+		if (ft_rit == ft_map.rend() || ft_rit->first != std_rit->first || ft_rit->second != std_rit->second)
+			return false;
+	return ft_rit == ft_map.rend();
+}
+
+// shuffled insertions, then every other key erased one by one and a range erased at once
+template <typename K, typename V>
+inline static bool	__insert_erase(ft::map<K, V> &ft_map, std::map<K, V> &std_map, size_t count)
+{
+	std::vector<K>	keys;
+	size_t			idx;
+
+	for (idx = 0U ; idx < count ; ++idx)
+		keys.push_back(static_cast<K>(idx));
+	std::random_shuffle(keys.begin(), keys.end());
+	for (idx = 0U ; idx < keys.size() ; ++idx)
+	{
+		ft_map.insert(ft::make_pair(keys[idx], static_cast<V>(-keys[idx])));
+		std_map.insert(std::make_pair(keys[idx], static_cast<V>(-keys[idx])));
+	}
+	if (!__same_content(ft_map, std_map))
+		return false;
+	for (idx = 0U ; idx < keys.size() ; idx += 2U)
+	{
+		ft_map.erase(keys[idx]);
+		std_map.erase(keys[idx]);
+	}
+	if (!__same_content(ft_map, std_map))
+		return false;
+	ft_map.erase(ft_map.lower_bound(static_cast<K>(count / 4U)), ft_map.lower_bound(static_cast<K>(count / 2U)));
+	std_map.erase(std_map.lower_bound(static_cast<K>(count / 4U)), std_map.lower_bound(static_cast<K>(count / 2U)));
+	return __same_content(ft_map, std_map);
+}
+#endif
+
+#ifdef FT_COMPACT_NODES
+inline static int	__test_function_compact_nodes(void)
+{
+	title(__func__);
+	try
+	{
+		ft::map<long, long>	ft_map;
+		std::map<long, long>	std_map;
+
+# ifndef FT_INDEX_NODES
+		// the color lives in the parent link: the data and the pointers
+		if (sizeof(ft::RBNode<long, ft::null_node_update>) != sizeof(long) + g_node_links * sizeof(void *))
+			return KO;
+# endif
+		if (!__insert_erase(ft_map, std_map, 5000U))
+			return KO;
+		// recolorings on the way back up, down to an empty tree
+		while (!std_map.empty())
+		{
+			ft_map.erase(ft_map.begin());
+			std_map.erase(std_map.begin());
+			if (std_map.size() % 100U == 0U && !__same_content(ft_map, std_map))
+				return KO;
+		}
+		if (!ft_map.empty() || ft_map.begin() != ft_map.end())
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+#endif
+
+#ifdef FT_INDEX_NODES
+inline static int	__test_function_index_nodes(void)
+{
+	title(__func__);
+	try
+	{
+		ft::map<long, long>		ft_map;
+		ft::map<long, long>		ft_other;
+		std::map<long, long>	std_map;
+		std::map<long, long>	std_other;
+
+		// 32 bit links and the data
+		if (sizeof(ft::RBNode<int, ft::null_node_update>) != sizeof(int) + g_node_links * 4U)
+			return KO;
+		// the pages of both pools interleave in the registry
+		if (!__insert_erase(ft_map, std_map, 5000U) || !__insert_erase(ft_other, std_other, 3000U))
+			return KO;
+		ft_map.swap(ft_other);
+		if (!__same_content(ft_map, std_other) || !__same_content(ft_other, std_map))
+			return KO;
+		{
+			ft::map<long, long>	ft_copy(ft_map);
+
+			ft_map.clear();
+			if (!__same_content(ft_copy, std_other) || !ft_map.empty())
+				return KO;
+			ft_map = ft_copy;
+		}
+		// the copy is gone, with its pages
+		if (!__same_content(ft_map, std_other) || !__same_content(ft_other, std_map))
+			return KO;
+		ft_map[-1] = 1;
+		std_other[-1] = 1;
+		if (!__same_content(ft_map, std_other))
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+#endif
+
+#ifdef FT_THREADED_NODES
+inline static int	__test_function_threaded_nodes(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, int>			ft_map;
+		ft::map<int, int>			ft_other;
+		std::map<int, int>			std_map;
+		ft::map<int, int>::iterator	ft_it;
+
+		if (!__insert_erase(ft_map, std_map, 5000U))
+			return KO;
+		// erasing while walking the in-order links
+		for (ft_it = ft_map.begin() ; ft_it != ft_map.end() ; )
+		{
+			if (ft_it->first % 3 == 0)
+			{
+				std_map.erase(ft_it->first);
+				ft_map.erase(ft_it++);
+			}
+			else
+				++ft_it;
+		}
+		if (!__same_content(ft_map, std_map))
+			return KO;
+		// stepping back from end() and forward from begin() at both ends
+		ft_it = ft_map.end();
+		--ft_it;
+		if (ft_it->first != std_map.rbegin()->first || ++ft_it != ft_map.end())
+			return KO;
+		ft_it = ft_map.begin();
+		++ft_it;
+		--ft_it;
+		if (ft_it != ft_map.begin() || ft_it->first != std_map.begin()->first)
+			return KO;
+		// the links are rebuilt on both sides of a split and after a concat
+		ft_map.split_at(2500, ft_other);
+		if (ft_other.begin()->first < 2500 || (--ft_map.end())->first >= 2500)
+			return KO;
+		for (key = 0 ; key < 100 ; ++key)
+		{
+			ft_other[10000 + key] = key;
+			std_map[10000 + key] = key;
+		}
+		ft_map.concat(ft_other);
+		if (!ft_other.empty() || !__same_content(ft_map, std_map))
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+#endif
+
+inline static int	__test_function_split_concat(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, int>					ft_map;
+		ft::map<int, int>					ft_other;
+		ft::map<int, int>::const_iterator	ft_it;
+
+		for (key = 0 ; key < 1000 ; ++key)
+			ft_map[key] = -key;
+		ft_other[2000] = 0;
+		ft_map.split_at(600, ft_other);
+		if (ft_map.size() != 600U || ft_other.size() != 400U || (--ft_map.end())->first != 599 ||
+			ft_other.begin()->first != 600 || ft_other.count(2000) || ft_map.find(600) != ft_map.end())
+			return KO;
+		ft_map.split_at(1000, ft_other);
+		if (ft_map.size() != 600U || !ft_other.empty())
+			return KO;
+		ft_map.split_at(400, ft_other);
+		ft_map.split_at(200, ft_map);
+		ft_other.concat(ft_map);
+		if (!ft_map.empty() || ft_other.size() != 600U)
+			return KO;
+		for (key = 0, ft_it = ft_other.begin() ; ft_it != ft_other.end() ; ++key, ++ft_it)
+			if (ft_it->first != key || ft_it->second != -key)
+				return KO;
+
+		// interleaved keys are moved one by one, and the ones already present stay behind
+		for (key = 500 ; key < 700 ; key += 2)
+			ft_map[key] = 1;
+		ft_other.concat(ft_map);
+		if (ft_other.size() != 650U || ft_map.size() != 50U || ft_map.begin()->first != 500 || ft_other[598] != -598 || ft_other[698] != 1)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_merge_intersect(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, int>					ft_map;
+		ft::map<int, int>					ft_other;
+		ft::map<int, int>::const_iterator	ft_it;
+
+		for (key = 0 ; key < 1000 ; key += 2)
+			ft_map[key] = key;
+		for (key = 0 ; key < 1500 ; key += 3)
+			ft_other[key] = -key;
+
+		// equivalent keys keep the element already there
+		ft_map.merge_from(ft_other);
+		if (ft_map.size() != 500U + 500U - 167U || ft_other.size() != 500U ||
+			ft_map[6] != 6 || ft_map[9] != -9 || ft_map[1497] != -1497 || (--ft_map.end())->first != 1497)
+			return KO;
+		for (key = 0, ft_it = ft_map.begin() ; ft_it != ft_map.end() ; ++key)
+			if ((key < 1000 && key % 2 == 0) || key % 3 == 0)
+			{
+				if (ft_it->first != key)
+					return KO;
+				++ft_it;
+			}
+
+		ft_other.erase(ft_other.begin(), ft_other.lower_bound(300));
+		ft_map.intersect_with(ft_other);
+		if (ft_map.size() != 400U || ft_map.begin()->first != 300 || ft_map[303] != -303 || ft_map[600] != 600)
+			return KO;
+		ft_map.intersect_with(ft_map);
+		ft_map.merge_from(ft_map);
+		if (ft_map.size() != 400U)
+			return KO;
+		ft_other.clear();
+		ft_map.intersect_with(ft_other);
+		if (!ft_map.empty() || ft_map.begin() != ft_map.end())
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_extract_insert_node(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, std::string>						ft_active;
+		ft::map<int, std::string>						ft_expired;
+		ft::map<int, std::string>::node_type			ft_node;
+		ft::map<int, std::string>::insert_return_type	ft_ret;
+		std::string const								*ft_value;
+
+		for (key = 0 ; key < 100 ; ++key)
+			ft_active[key] = std::string(64U, static_cast<char>('a' + key % 26));
+
+		// the value moves with its node, back into its map
+		ft_value = &ft_active[42];
+		ft_node = ft_active.extract(42);
+		if (ft_node.empty() || ft_node.key() != 42 || &ft_node.mapped() != ft_value || ft_active.size() != 99U || ft_active.count(42))
+			return KO;
+		ft_ret = ft_active.insert(ft_node);
+		if (!ft_ret.inserted || !ft_node.empty() || !ft_ret.node.empty() || &ft_ret.position->second != ft_value || ft_active.size() != 100U)
+			return KO;
+
+		// another map, with a pool of its own, takes a copy
+		ft_node = ft_active.extract(42);
+		ft_ret = ft_expired.insert(ft_node);
+		if (!ft_ret.inserted || !ft_node.empty() || !ft_ret.node.empty() || ft_ret.position->second != std::string(64U, 'a' + 42 % 26))
+			return KO;
+
+		// a key already present gives the node back
+		ft_node = ft_active.extract(ft_active.begin());
+		ft_node.key() = 42;
+		ft_ret = ft_expired.insert(ft_node);
+		if (ft_ret.inserted || ft_ret.node.empty() || ft_ret.node.mapped() != std::string(64U, 'a') || ft_ret.position != ft_expired.find(42))
+			return KO;
+		ft_ret.node.key() = 1000;
+		ft_ret = ft_expired.insert(ft_ret.node);
+		if (!ft_ret.inserted || ft_expired.size() != 2U || (--ft_expired.end())->first != 1000)
+			return KO;
+		if (!ft_active.extract(0).empty() || ft_expired.insert(ft_active.extract(0)).inserted)
+			return KO;
+
+		// merge moves the keys missing here and leaves the others
+		for (key = 90 ; key < 110 ; ++key)
+			ft_expired[key] = "expired";
+		ft_active.merge(ft_expired);
+		if (ft_active.size() != 98U + 12U || ft_expired.size() != 10U || ft_active[42] != std::string(64U, 'a' + 42 % 26) ||
+			ft_active[1000] != std::string(64U, 'a') || ft_active[95] != std::string(64U, static_cast<char>('a' + 95 % 26)))
+			return KO;
+		for (key = 90 ; key < 100 ; ++key)
+			if (ft_expired[key] != "expired")
+				return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_find_many(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, int>								ft_map;
+		ft::map<int, int> const							&ft_cmap = ft_map;
+		std::vector<int>								ft_keys;
+		std::vector<ft::map<int, int>::iterator>		ft_found;
+		std::vector<ft::map<int, int>::const_iterator>	ft_cfound;
+		size_t											idx;
+
+		// nothing to find in an empty map
+		for (key = 0 ; key < 20 ; ++key)
+			ft_keys.push_back(key);
+		ft_map.find_many(ft_keys.begin(), ft_keys.end(), std::back_inserter(ft_found));
+		if (ft_found.size() != 20U || ft_found[0] != ft_map.end() || ft_found[19] != ft_map.end())
+			return KO;
+
+		// several batches, with missing and repeated keys, results in the order of the keys
+		for (key = 0 ; key < 2000 ; key += 2)
+			ft_map[key] = -key;
+		ft_keys.clear();
+		for (key = 0 ; key < 300 ; ++key)
+			ft_keys.push_back((key * 37) % 2101 - 50);
+		ft_keys.push_back(0);
+		ft_keys.push_back(1998);
+		ft_found.clear();
+		ft_map.find_many(ft_keys.begin(), ft_keys.end(), std::back_inserter(ft_found));
+		ft_cmap.find_many(ft_keys.begin(), ft_keys.end(), std::back_inserter(ft_cfound));
+		if (ft_found.size() != ft_keys.size() || ft_cfound.size() != ft_keys.size())
+			return KO;
+		for (idx = 0U ; idx < ft_keys.size() ; ++idx)
+			if (ft_found[idx] != ft_map.find(ft_keys[idx]) || ft_cfound[idx] != ft_cmap.find(ft_keys[idx]))
+				return KO;
+		ft_found[ft_keys.size() - 2U]->second = 42;
+		if (ft_map[0] != 42 || ft_found.back()->second != -1998)
+			return KO;
+		if (ft_map.find_many(ft_keys.begin(), ft_keys.begin(), ft_found.begin()) != ft_found.begin())
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_compact(void)
+{
+	std::vector<int>	keys;
+	size_t				idx;
+
+	title(__func__);
+	try
+	{
+		ft::map<int, __counted>					ft_map;
+		std::map<int, int>						std_map;
+		ft::map<int, __counted>::iterator		ft_it;
+		std::map<int, int>::iterator			std_it;
+		__counted const							*prev;
+
+		ft_map.compact();
+		if (!ft_map.empty() || ft_map.begin() != ft_map.end())
+			return KO;
+
+		// scattered nodes, from shuffled insertions and erasures
+		for (idx = 0U ; idx < 3000U ; ++idx)
+			keys.push_back(static_cast<int>(idx));
+		std::random_shuffle(keys.begin(), keys.end());
+		for (idx = 0U ; idx < keys.size() ; ++idx)
+		{
+			ft_map[keys[idx]] = __counted(-keys[idx]);
+			std_map[keys[idx]] = -keys[idx];
+		}
+		for (idx = 0U ; idx < keys.size() ; idx += 3U)
+		{
+			ft_map.erase(keys[idx]);
+			std_map.erase(keys[idx]);
+		}
+
+		// in key order, every value lies after the previous one, and is moved only once
+		__counted::reset();
+		ft_map.compact(ft::in_order_layout);
+		if (__counted::copies > ft_map.size() || __counted::assignments)
+			return KO;
+		for (prev = NULL, ft_it = ft_map.begin(), std_it = std_map.begin() ; std_it != std_map.end() ; prev = &ft_it->second, ++ft_it, ++std_it)
+			if (ft_it->first != std_it->first || ft_it->second.value != std_it->second || (prev && !(prev < &ft_it->second)))
+				return KO;
+		if (ft_it != ft_map.end() || (--ft_map.end())->first != std_map.rbegin()->first || ft_map.rbegin()->first != std_map.rbegin()->first)
+			return KO;
+
+		// the map keeps working, from either layout
+		ft_map.compact(ft::van_emde_boas_layout);
+		for (idx = 0U ; idx < keys.size() ; idx += 2U)
+		{
+			ft_map.erase(keys[idx]);
+			std_map.erase(keys[idx]);
+		}
+		ft_map[-1] = __counted(1);
+		std_map[-1] = 1;
+		if (ft_map.size() != std_map.size())
+			return KO;
+		for (ft_it = ft_map.begin(), std_it = std_map.begin() ; std_it != std_map.end() ; ++ft_it, ++std_it)
+			if (ft_it->first != std_it->first || ft_it->second.value != std_it->second || ft_map.find(std_it->first) != ft_it)
+				return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	try
+	{
+		ft::map<int, __throwing_copy>	ft_map;
+		int								key;
+
+		for (key = 0 ; key < 100 ; ++key)
+			ft_map.insert(ft::make_pair(key, __throwing_copy(key)));
+
+		// a copy failing halfway leaves the map as it was
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft_map.compact();
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		__throwing_copy::copies_left = -1;
+		if (ft_map.size() != 100U)
+			return KO;
+		for (key = 0 ; key < 100 ; ++key)
+			if (ft_map.find(key) == ft_map.end() || ft_map.find(key)->second.value != key)
+				return KO;
+		ft_map.erase(50);
+		ft_map.compact(ft::van_emde_boas_layout);
+		if (ft_map.size() != 99U || ft_map.begin()->second.value != 0 || ft_map.rbegin()->second.value != 99)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_interval_map(void)
+{
+	typedef ft::interval_map<int, char>	t_interval_map;
+
+	int									low;
+	std::vector<t_interval_map::iterator>	found;
+
+	title(__func__);
+	try
+	{
+		t_interval_map			ft_map;
+		t_interval_map const	&ft_cmap = ft_map;
+
+		// [low, low + 10) for every multiple of 5 below 100, two intervals cover each point
+		for (low = 0 ; low < 100 ; low += 5)
+			ft_map[ft::make_pair(low, low + 10)] = static_cast<char>('a' + low / 5);
+		ft_map.insert(ft::make_pair(ft::make_pair(40, 90), 'z'));
+		if (ft_map.size() != 21U || ft_map.count(ft::make_pair(40, 90)) != 1U || ft_map.count(ft::make_pair(40, 91)) != 0U)
+			return KO;
+
+		ft_map.overlapping(42, 43, std::back_inserter(found));
+		if (found.size() != 3U || found[0]->second != 'h' || found[1]->second != 'i' || found[2]->second != 'z')
+			return KO;
+		if (ft_cmap.count_overlaps(0, 100) != 21U || ft_cmap.count_overlaps(105, 200) != 0U ||
+			ft_cmap.count_overlaps(95, 96) != 2U || ft_cmap.count_overlaps(89, 91) != 4U)
+			return KO;
+		if (ft_cmap.find_overlap(42, 43)->second != 'h' || ft_map.find_overlap(-10, 0) != ft_map.end() ||
+			!ft_cmap.overlaps(104, 200) || ft_cmap.overlaps(105, 200))
+			return KO;
+
+		// erasing must keep the highest end of every subtree right
+		ft_map.erase(ft::make_pair(40, 90));
+		ft_map.erase(ft_map.find(ft::make_pair(95, 105)));
+		ft_map.erase(ft_map.lower_bound(ft::make_pair(10, 0)), ft_map.lower_bound(ft::make_pair(50, 0)));
+		if (ft_map.size() != 11U || ft_cmap.count_overlaps(60, 70) != 3U || ft_cmap.count_overlaps(20, 45) != 0U ||
+			ft_cmap.find_overlap(16, 60)->second != 'k' || ft_cmap.overlaps(100, 200))
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
 inline static int	__test_function_erase_range(void)
 {
 	t_uint	idx;
@@ -3770,6 +4677,7 @@ int	test_map(void)
 		__test_constructor_default,
 		__test_constructor_range,
 		__test_constructor_copy,
+		__test_constructor_range_sorted,
 		__test_default_template_type_Compare,
 		__test_default_template_type_Alloc,
 		__test_type_key_type,
@@ -3798,9 +4706,31 @@ int	test_map(void)
 		__test_type_const_iterator,
 		__test_type_reverse_iterator,
 		__test_type_const_reverse_iterator,
+		__test_type_reverse_iterator_base,
 		__test_function_insert_range,
+		__test_function_copy_throw,
 		__test_function_insert_single,
 		__test_function_insert_single_hint,
+		__test_function_emplace_copies,
+		__test_function_transparent_lookup,
+#ifdef FT_ORDER_STATISTICS
+		__test_function_order_statistics,
+#endif
+#ifdef FT_COMPACT_NODES
+		__test_function_compact_nodes,
+#endif
+#ifdef FT_INDEX_NODES
+		__test_function_index_nodes,
+#endif
+#ifdef FT_THREADED_NODES
+		__test_function_threaded_nodes,
+#endif
+		__test_function_split_concat,
+		__test_function_merge_intersect,
+		__test_function_extract_insert_node,
+		__test_function_find_many,
+		__test_function_compact,
+		__test_function_interval_map,
 		__test_function_erase_range,
 		__test_function_erase_single_position,
 		__test_function_erase_single_key,
@@ -19,11 +19,15 @@
 #include "iterator/restrictor/random_access_iterator_restrictor.tpp"
 #include "tester.hpp"
 #include "e_ret.hpp"
+#include "values.hpp"
 #include SET_HEADER
 #include <algorithm>
 #include <ctime>
 #include <iostream>
+#include <iterator>
 #include <set>
+#include <stdexcept>
+#include <vector>
 
 inline static int	__test_constructor_default(void)
 {
@@ -955,7 +959,7 @@ inline static int	__test_function_end_constant(void)
 		std::cerr << "Exception: " << e.what() << '\n';
 		return KO;
 	}
-	return IMP_OK;
+	return ret;
 }
 
 inline static int	__test_function_end_mutable(void)
@@ -1020,7 +1024,7 @@ inline static int	__test_function_end_mutable(void)
 		std::cerr << "Exception: " << e.what() << '\n';
 		return KO;
 	}
-	return IMP_OK;
+	return ret;
 }
 
 inline static int	__test_function_rbegin_constant(void)
@@ -1464,6 +1468,105 @@ inline static int	__test_function_insert_range(void)
 		std::cerr << "Exception: " << e.what() << '\n';
 		return KO;
 	}
+	try
+	{
+		ft::set<__throwing_copy>	ft_src;
+		ft::set<__throwing_copy>	ft_set;
+		int							key;
+		int							alive;
+
+		for (key = 0 ; key < 100 ; ++key)
+			ft_src.insert(__throwing_copy(key));
+
+		// a copy failing halfway through a sorted build leaves the set empty, and every value built is destroyed
+		alive = __throwing_copy::alive;
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft_set.insert(ft_src.begin(), ft_src.end());
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		__throwing_copy::copies_left = -1;
+		if (!ft_set.empty() || ft_set.begin() != ft_set.end() || __throwing_copy::alive != alive)
+			return KO;
+		ft_set.insert(ft_src.begin(), ft_src.end());
+		if (ft_set.size() != 100U || ft_set.begin()->value != 0 || ft_set.rbegin()->value != 99)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_copy_throw(void)
+{
+	int	key;
+	int	alive;
+
+	title(__func__);
+	try
+	{
+		ft::set<__throwing_copy>	ft_src;
+		ft::set<__throwing_copy>	ft_small;
+		ft::set<__throwing_copy>	ft_big;
+
+		for (key = 0 ; key < 100 ; ++key)
+			ft_src.insert(__throwing_copy(key));
+		for (key = 0 ; key < 30 ; ++key)
+			ft_small.insert(__throwing_copy(-key));
+		for (key = 0 ; key < 300 ; ++key)
+			ft_big.insert(__throwing_copy(-key));
+
+		// a copy constructor failing halfway through destroys every value it built
+		alive = __throwing_copy::alive;
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft::set<__throwing_copy>	ft_copy(ft_src);
+
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		if (__throwing_copy::alive != alive)
+			return KO;
+
+		// a failing assignment leaves the set empty, from recycled nodes or new ones
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft_small = ft_src;
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft_big = ft_src;
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		__throwing_copy::copies_left = -1;
+		if (__throwing_copy::alive != alive - 330 ||
+			!ft_small.empty() || ft_small.begin() != ft_small.end() ||
+			!ft_big.empty() || ft_big.begin() != ft_big.end())
+			return KO;
+
+		// both sets keep working
+		ft_small = ft_src;
+		ft_big.insert(__throwing_copy(1000));
+		if (ft_small.size() != 100U || ft_small.begin()->value != 0 || ft_small.rbegin()->value != 99 ||
+			ft_big.size() != 1U || ft_big.begin()->value != 1000)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
 	return IMP_OK;
 }
 
@@ -1581,6 +1684,352 @@ inline static int	__test_function_insert_single_hint(void)
 	return IMP_OK;
 }
 
+inline static int	__test_function_transparent_lookup(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::set<__counted, __counted_less>			ft_set;
+		ft::set<__counted, __counted_less> const	&ft_cset = ft_set;
+
+		for (key = 0 ; key < 100 ; key += 2)
+			ft_set.insert(__counted(key));
+
+		// __counted has no operator==, and looking it up by int must not build any
+		__counted::reset();
+		for (key = -1 ; key < 101 ; ++key)
+		{
+			if ((ft_set.find(key) == ft_set.end()) != (key % 2 != 0 || key < 0 || key >= 100) ||
+				(ft_cset.find(key) != ft_cset.end() && ft_cset.find(key)->value != key) ||
+				ft_set.count(key) != static_cast<size_t>(key % 2 == 0 && key >= 0 && key < 100) ||
+				(ft_set.lower_bound(key) != ft_set.end() && ft_set.lower_bound(key)->value != key + (key % 2 != 0)) ||
+				(ft_cset.upper_bound(key) != ft_cset.end() && ft_cset.upper_bound(key)->value != key + 1 + (key % 2 == 0)) ||
+				ft_set.equal_range(key).second != ft_set.upper_bound(key))
+				return KO;
+		}
+		if (ft_set.erase(42) != 1U || ft_set.erase(43) != 0U || ft_set.count(42) || ft_set.size() != 49U)
+			return KO;
+		if (__counted::constructions || __counted::copies)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_split_concat(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::set<int>					ft_set;
+		ft::set<int>					ft_other;
+		ft::set<int>::const_iterator	ft_it;
+
+		for (key = 0 ; key < 1000 ; ++key)
+			ft_set.insert(key);
+		ft_other.insert(2000);
+		ft_set.split_at(600, ft_other);
+		if (ft_set.size() != 600U || ft_other.size() != 400U || *(--ft_set.end()) != 599 ||
+			*ft_other.begin() != 600 || ft_other.count(2000) || ft_set.find(600) != ft_set.end())
+			return KO;
+		ft_set.split_at(1000, ft_other);
+		if (ft_set.size() != 600U || !ft_other.empty())
+			return KO;
+		ft_set.split_at(400, ft_other);
+		ft_set.split_at(200, ft_set);
+		ft_other.concat(ft_set);
+		if (!ft_set.empty() || ft_other.size() != 600U)
+			return KO;
+		for (key = 0, ft_it = ft_other.begin() ; ft_it != ft_other.end() ; ++key, ++ft_it)
+			if (*ft_it != key)
+				return KO;
+
+		// interleaved values are moved one by one, and the ones already present stay behind
+		for (key = 500 ; key < 700 ; key += 2)
+			ft_set.insert(key);
+		ft_other.concat(ft_set);
+		if (ft_other.size() != 650U || ft_set.size() != 50U || *ft_set.begin() != 500 || *ft_set.rbegin() != 598 ||
+			!ft_other.count(598) || !ft_other.count(698) || ft_other.count(699))
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_merge_intersect(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::set<__counted, __counted_less>					ft_set;
+		ft::set<__counted, __counted_less>					ft_other;
+		ft::set<__counted, __counted_less>::const_iterator	ft_it;
+		__counted const										*ft_value;
+
+		for (key = 0 ; key < 1000 ; key += 2)
+			ft_set.insert(__counted(key));
+		for (key = 0 ; key < 1500 ; key += 3)
+			ft_other.insert(__counted(key));
+
+		// equivalent values keep the element already there, and only the added ones are copied
+		ft_value = &*ft_set.find(6);
+		__counted::reset();
+		ft_set.merge_from(ft_other);
+		if (ft_set.size() != 500U + 500U - 167U || ft_other.size() != 500U || __counted::copies != 500U - 167U ||
+			&*ft_set.find(6) != ft_value || !ft_set.count(9) || (--ft_set.end())->value != 1497)
+			return KO;
+		for (key = 0, ft_it = ft_set.begin() ; ft_it != ft_set.end() ; ++key)
+			if ((key < 1000 && key % 2 == 0) || key % 3 == 0)
+			{
+				if (ft_it->value != key)
+					return KO;
+				++ft_it;
+			}
+
+		ft_other.erase(ft_other.begin(), ft_other.lower_bound(300));
+		ft_set.intersect_with(ft_other);
+		if (ft_set.size() != 400U || ft_set.begin()->value != 300 || !ft_set.count(303) || !ft_set.count(600) || ft_set.count(602))
+			return KO;
+		ft_set.intersect_with(ft_set);
+		ft_set.merge_from(ft_set);
+		if (ft_set.size() != 400U)
+			return KO;
+		ft_other.clear();
+		ft_set.intersect_with(ft_other);
+		if (!ft_set.empty() || ft_set.begin() != ft_set.end())
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_extract_insert_node(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::set<int>						ft_active;
+		ft::set<int>						ft_expired;
+		ft::set<int>::node_type				ft_node;
+		ft::set<int>::insert_return_type	ft_ret;
+		int const							*ft_value;
+
+		for (key = 0 ; key < 100 ; ++key)
+			ft_active.insert(key);
+
+		// the value moves with its node, back into its set
+		ft_value = &*ft_active.find(42);
+		ft_node = ft_active.extract(42);
+		if (ft_node.empty() || ft_node.value() != 42 || &ft_node.value() != ft_value || ft_active.size() != 99U || ft_active.count(42))
+			return KO;
+		ft_ret = ft_active.insert(ft_node);
+		if (!ft_ret.inserted || !ft_node.empty() || !ft_ret.node.empty() || &*ft_ret.position != ft_value || ft_active.size() != 100U)
+			return KO;
+
+		// another set, with a pool of its own, takes a copy
+		ft_node = ft_active.extract(42);
+		ft_ret = ft_expired.insert(ft_node);
+		if (!ft_ret.inserted || !ft_node.empty() || !ft_ret.node.empty() || *ft_ret.position != 42)
+			return KO;
+
+		// a value already present gives the node back
+		ft_node = ft_active.extract(ft_active.begin());
+		ft_node.value() = 42;
+		ft_ret = ft_expired.insert(ft_node);
+		if (ft_ret.inserted || ft_ret.node.empty() || ft_ret.node.value() != 42 || ft_ret.position != ft_expired.find(42))
+			return KO;
+		ft_ret.node.value() = 1000;
+		ft_ret = ft_expired.insert(ft_ret.node);
+		if (!ft_ret.inserted || ft_expired.size() != 2U || *(--ft_expired.end()) != 1000)
+			return KO;
+		if (!ft_active.extract(0).empty() || ft_expired.insert(ft_active.extract(0)).inserted)
+			return KO;
+
+		// merge moves the values missing here and leaves the others
+		for (key = 90 ; key < 110 ; ++key)
+			ft_expired.insert(key);
+		ft_active.merge(ft_expired);
+		if (ft_active.size() != 98U + 12U || ft_expired.size() != 10U || !ft_active.count(42) ||
+			!ft_active.count(1000) || !ft_active.count(105) || ft_active.count(0))
+			return KO;
+		for (key = 90 ; key < 100 ; ++key)
+			if (!ft_expired.count(key))
+				return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_find_many(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::set<int>								ft_set;
+		std::vector<int>							ft_keys;
+		std::vector<ft::set<int>::iterator>			ft_found;
+		size_t										idx;
+
+		// nothing to find in an empty set
+		for (key = 0 ; key < 20 ; ++key)
+			ft_keys.push_back(key);
+		ft_set.find_many(ft_keys.begin(), ft_keys.end(), std::back_inserter(ft_found));
+		if (ft_found.size() != 20U || ft_found[0] != ft_set.end() || ft_found[19] != ft_set.end())
+			return KO;
+
+		// several batches, with missing and repeated values, results in the order of the values
+		for (key = 0 ; key < 2000 ; key += 2)
+			ft_set.insert(key);
+		ft_keys.clear();
+		for (key = 0 ; key < 300 ; ++key)
+			ft_keys.push_back((key * 37) % 2101 - 50);
+		ft_keys.push_back(0);
+		ft_keys.push_back(1998);
+		ft_found.clear();
+		ft_set.find_many(ft_keys.begin(), ft_keys.end(), std::back_inserter(ft_found));
+		if (ft_found.size() != ft_keys.size())
+			return KO;
+		for (idx = 0U ; idx < ft_keys.size() ; ++idx)
+			if (ft_found[idx] != ft_set.find(ft_keys[idx]))
+				return KO;
+		if (*ft_found[ft_keys.size() - 2U] != 0 || *ft_found.back() != 1998)
+			return KO;
+		if (ft_set.find_many(ft_keys.begin(), ft_keys.begin(), ft_found.begin()) != ft_found.begin())
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_compact(void)
+{
+	std::vector<int>	keys;
+	size_t				idx;
+
+	title(__func__);
+	try
+	{
+		ft::set<__counted, __counted_less>				ft_set;
+		std::set<int>									std_set;
+		ft::set<__counted, __counted_less>::iterator	ft_it;
+		std::set<int>::iterator							std_it;
+		__counted const									*prev;
+
+		ft_set.compact();
+		if (!ft_set.empty() || ft_set.begin() != ft_set.end())
+			return KO;
+
+		// scattered nodes, from shuffled insertions and erasures
+		for (idx = 0U ; idx < 3000U ; ++idx)
+			keys.push_back(static_cast<int>(idx));
+		std::random_shuffle(keys.begin(), keys.end());
+		for (idx = 0U ; idx < keys.size() ; ++idx)
+		{
+			ft_set.insert(__counted(keys[idx]));
+			std_set.insert(keys[idx]);
+		}
+		for (idx = 0U ; idx < keys.size() ; idx += 3U)
+		{
+			ft_set.erase(keys[idx]);
+			std_set.erase(keys[idx]);
+		}
+
+		// in order, every value lies after the previous one, and is moved only once
+		__counted::reset();
+		ft_set.compact(ft::in_order_layout);
+		if (__counted::copies > ft_set.size() || __counted::assignments)
+			return KO;
+		for (prev = NULL, ft_it = ft_set.begin(), std_it = std_set.begin() ; std_it != std_set.end() ; prev = &*ft_it, ++ft_it, ++std_it)
+			if (ft_it->value != *std_it || (prev && !(prev < &*ft_it)))
+				return KO;
+		if (ft_it != ft_set.end() || (--ft_set.end())->value != *std_set.rbegin() || ft_set.rbegin()->value != *std_set.rbegin())
+			return KO;
+
+		// the set keeps working, from either layout
+		ft_set.compact(ft::van_emde_boas_layout);
+		for (idx = 0U ; idx < keys.size() ; idx += 2U)
+		{
+			ft_set.erase(keys[idx]);
+			std_set.erase(keys[idx]);
+		}
+		ft_set.insert(__counted(-1));
+		std_set.insert(-1);
+		if (ft_set.size() != std_set.size())
+			return KO;
+		for (ft_it = ft_set.begin(), std_it = std_set.begin() ; std_it != std_set.end() ; ++ft_it, ++std_it)
+			if (ft_it->value != *std_it || ft_set.find(*std_it) != ft_it)
+				return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	try
+	{
+		ft::set<__throwing_copy>	ft_set;
+		int							key;
+
+		for (key = 0 ; key < 100 ; ++key)
+			ft_set.insert(__throwing_copy(key));
+
+		// a copy failing halfway leaves the set as it was
+		__throwing_copy::copies_left = 50;
+		try
+		{
+			ft_set.compact();
+			return KO;
+		}
+		catch (std::runtime_error const &) {}
+		__throwing_copy::copies_left = -1;
+		if (ft_set.size() != 100U)
+			return KO;
+		for (key = 0 ; key < 100 ; ++key)
+			if (ft_set.find(__throwing_copy(key)) == ft_set.end() || ft_set.find(__throwing_copy(key))->value != key)
+				return KO;
+		ft_set.erase(__throwing_copy(50));
+		ft_set.compact(ft::van_emde_boas_layout);
+		if (ft_set.size() != 99U || ft_set.begin()->value != 0 || ft_set.rbegin()->value != 99)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
 inline static int	__test_function_erase_range(void)
 {
 	t_uint	idx;
@@ -3108,8 +3557,15 @@ int	test_set(void)
 		__test_type_reverse_iterator,
 		__test_type_const_reverse_iterator,
 		__test_function_insert_range,
+		__test_function_copy_throw,
 		__test_function_insert_single,
 		__test_function_insert_single_hint,
+		__test_function_transparent_lookup,
+		__test_function_split_concat,
+		__test_function_merge_intersect,
+		__test_function_extract_insert_node,
+		__test_function_find_many,
+		__test_function_compact,
 		__test_function_erase_range,
 		__test_function_erase_single_position,
 		__test_function_erase_single_key,
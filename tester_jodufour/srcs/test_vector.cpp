@@ -28,6 +28,9 @@
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <list>
+#include <sstream>
+#include <string>
 #include <vector>
 
 inline static int	__test_constructor_default(void)
@@ -2026,6 +2029,306 @@ inline static int	__test_function_erase_single(void)
 	return ret;
 }
 
+inline static int	__test_function_erase_elements(void)
+{
+	t_uint	idx;
+
+	title(__func__);
+	try
+	{
+		ft::vector<std::string>					ft_vec;
+		std::vector<std::string>				std_vec;
+		ft::vector<std::string>::iterator		ft_ret;
+		std::vector<std::string>::iterator		std_ret;
+
+		for (idx = 0U ; idx < 200U ; ++idx)
+		{
+			ft_vec.push_back(std::string(idx % 40U, 'a' + idx % 26));
+			std_vec.push_back(std::string(idx % 40U, 'a' + idx % 26));
+		}
+
+		// front, middle, last, ranges and empty ranges, the tail being shifted by assignment
+		ft_ret = ft_vec.erase(ft_vec.begin());
+		std_ret = std_vec.erase(std_vec.begin());
+		if (ft_ret != ft_vec.begin() || *ft_ret != *std_ret)
+			return KO;
+		ft_ret = ft_vec.erase(ft_vec.begin() + 50);
+		std_ret = std_vec.erase(std_vec.begin() + 50);
+		if (ft_ret - ft_vec.begin() != 50 || *ft_ret != *std_ret)
+			return KO;
+		ft_ret = ft_vec.erase(ft_vec.end() - 1);
+		std_vec.erase(std_vec.end() - 1);
+		if (ft_ret != ft_vec.end())
+			return KO;
+		ft_ret = ft_vec.erase(ft_vec.begin() + 10, ft_vec.begin() + 60);
+		std_ret = std_vec.erase(std_vec.begin() + 10, std_vec.begin() + 60);
+		if (ft_ret - ft_vec.begin() != 10 || *ft_ret != *std_ret)
+			return KO;
+		ft_ret = ft_vec.erase(ft_vec.begin() + 20, ft_vec.begin() + 20);
+		std_vec.erase(std_vec.begin() + 20, std_vec.begin() + 20);
+		if (ft_ret - ft_vec.begin() != 20)
+			return KO;
+		ft_ret = ft_vec.erase(ft_vec.begin() + 100, ft_vec.end());
+		std_vec.erase(std_vec.begin() + 100, std_vec.end());
+		if (ft_ret != ft_vec.end() || ft_vec.capacity() < 200U)
+			return KO;
+		if (ft_vec.size() != std_vec.size() || !std::equal(ft_vec.begin(), ft_vec.end(), std_vec.begin()))
+			return KO;
+
+		// the vacated tail can be reused right away
+		ft_vec.push_back("tail");
+		std_vec.push_back("tail");
+		ft_vec.erase(ft_vec.begin(), ft_vec.end());
+		if (!ft_vec.empty() || ft_vec.erase(ft_vec.begin(), ft_vec.end()) != ft_vec.end())
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+/**
+ * @brief	Plain structure, copied and destroyed bytewise by ft::vector.
+ */
+struct __pod
+{
+	int		number;
+	char	name[12];
+};
+
+inline static int	__test_function_trivial_elements(void)
+{
+	t_uint	idx;
+
+	title(__func__);
+	try
+	{
+		ft::vector<__pod>			ft_pods;
+		ft::vector<std::string>		ft_strings;
+		std::vector<std::string>	std_strings;
+		__pod						pod;
+
+		if (!ft::is_trivially_copyable<int>::value || !ft::is_trivially_copyable<__pod>::value || !ft::is_trivially_destructible<__pod>::value ||
+			ft::is_trivially_copyable<std::string>::value || ft::is_trivially_destructible<std::string>::value)
+			return KO;
+
+		// bytewise relocation and shifts
+		for (idx = 0U ; idx < 1000U ; ++idx)
+		{
+			pod.number = static_cast<int>(idx);
+			memset(pod.name, 'a' + idx % 26, sizeof(pod.name));
+			ft_pods.push_back(pod);
+		}
+		ft_pods.erase(ft_pods.begin());
+		ft_pods.erase(ft_pods.begin() + 100, ft_pods.begin() + 200);
+		ft_pods.erase(ft_pods.end() - 1);
+		ft_pods.erase(ft_pods.end(), ft_pods.end());
+		if (ft_pods.size() != 898U || ft_pods[0].number != 1 || ft_pods[99].number != 100 || ft_pods[100].number != 201 ||
+			ft_pods.back().number != 998 || ft_pods[100].name[11] != 'a' + 201 % 26)
+			return KO;
+
+		// element by element for everything else
+		for (idx = 0U ; idx < 1000U ; ++idx)
+		{
+			ft_strings.push_back(std::string(idx % 40U, 'a' + idx % 26));
+			std_strings.push_back(std::string(idx % 40U, 'a' + idx % 26));
+		}
+		ft_strings.erase(ft_strings.begin() + 10, ft_strings.begin() + 500);
+		std_strings.erase(std_strings.begin() + 10, std_strings.begin() + 500);
+		ft_strings.erase(ft_strings.begin());
+		std_strings.erase(std_strings.begin());
+		ft_strings.resize(300U);
+		std_strings.resize(300U);
+		if (ft_strings.size() != std_strings.size() || !std::equal(ft_strings.begin(), ft_strings.end(), std_strings.begin()))
+			return KO;
+		ft_strings.clear();
+		if (!ft_strings.empty())
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+/**
+ * @brief	Owner of a heap allocated int, counting its copies, declared trivially relocatable.
+ */
+struct __handle
+{
+	static t_uint	copies;
+
+	int	*value;
+
+	__handle(int const n = 0) : value(new int(n)) {}
+	__handle(__handle const &src) : value(new int(*src.value)) { ++copies; }
+	~__handle(void) { delete value; }
+
+	__handle	&operator=(__handle const &rhs) { *value = *rhs.value; ++copies; return *this; }
+};
+
+t_uint	__handle::copies = 0U;
+
+namespace ft
+{
+	template <>
+	struct is_trivially_relocatable<__handle> : public true_type {};
+}
+
+inline static int	__test_function_relocation(void)
+{
+	int	key;
+
+	title(__func__);
+	try
+	{
+		ft::vector<__handle>	ft_vec;
+		int const				*first;
+
+		if (!ft::is_trivially_relocatable<int>::value || ft::is_trivially_relocatable<std::string>::value)
+			return KO;
+		for (key = 0 ; key < 100 ; ++key)
+			ft_vec.push_back(__handle(key));
+
+		// growing, inserting and erasing move the handles without copying them
+		__handle::copies = 0U;
+		first = ft_vec[0].value;
+		ft_vec.reserve(1000U);
+		ft_vec.erase(ft_vec.begin() + 10, ft_vec.begin() + 20);
+		ft_vec.erase(ft_vec.begin() + 1);
+		if (__handle::copies || ft_vec[0].value != first)
+			return KO;
+		// only the inserted values are copied, once from the argument then once per element
+		ft_vec.insert(ft_vec.begin() + 50, 3U, __handle(-1));
+		if (__handle::copies != 4U)
+			return KO;
+		ft_vec.insert(ft_vec.begin(), ft_vec[10]);
+		if (__handle::copies != 6U || ft_vec[1].value != first)
+			return KO;
+		if (ft_vec.size() != 93U || *ft_vec[0].value != 21 || *ft_vec[2].value != 2 || *ft_vec[10].value != 20 ||
+			*ft_vec[51].value != -1 || *ft_vec[53].value != -1 || *ft_vec[54].value != 61 || *ft_vec.back().value != 99)
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_insert_in_place(void)
+{
+	t_uint	idx;
+
+	title(__func__);
+	try
+	{
+		ft::vector<std::string>		ft_vec;
+		std::vector<std::string>	std_vec;
+		std::list<std::string>		words;
+		std::istringstream			ft_input("one two three");
+		std::istringstream			std_input("one two three");
+		std::string const			*data;
+
+		for (idx = 0U ; idx < 100U ; ++idx)
+		{
+			ft_vec.push_back(std::string(idx % 30U, 'a' + idx % 26));
+			std_vec.push_back(std::string(idx % 30U, 'a' + idx % 26));
+		}
+		words.push_back("alpha");
+		words.push_back("beta");
+
+		// within capacity, the elements stay where they are
+		ft_vec.reserve(200U);
+		std_vec.reserve(200U);
+		data = &ft_vec[0];
+		ft_vec.insert(ft_vec.begin() + 90, 20U, "x");
+		std_vec.insert(std_vec.begin() + 90, 20U, "x");
+		ft_vec.insert(ft_vec.begin() + 5, words.begin(), words.end());
+		std_vec.insert(std_vec.begin() + 5, words.begin(), words.end());
+		ft_vec.insert(ft_vec.end() - 1, ft_vec[3]);
+		std_vec.insert(std_vec.end() - 1, std_vec[3]);
+		if (&ft_vec[0] != data || ft_vec.capacity() != 200U)
+			return KO;
+
+		// beyond it, one reallocation to the final size at least
+		ft_vec.insert(ft_vec.begin() + 50, 150U, ft_vec[60]);
+		std_vec.insert(std_vec.begin() + 50, 150U, std_vec[60]);
+		ft_vec.insert(ft_vec.begin() + 1, std::istream_iterator<std::string>(ft_input), std::istream_iterator<std::string>());
+		std_vec.insert(std_vec.begin() + 1, std::istream_iterator<std::string>(std_input), std::istream_iterator<std::string>());
+		if (ft_vec.capacity() < ft_vec.size() || ft_vec.size() != std_vec.size() || !std::equal(ft_vec.begin(), ft_vec.end(), std_vec.begin()))
+			return KO;
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
+inline static int	__test_function_exact_size_ranges(void)
+{
+	t_uint	idx;
+
+	title(__func__);
+	try
+	{
+		std::list<std::string>		words;
+		std::istringstream			input("one two three four five");
+
+		for (idx = 0U ; idx < 1000U ; ++idx)
+			words.push_back(std::string(idx % 20U, 'a' + idx % 26));
+
+		// forward ranges and copies allocate their exact size once
+		ft::vector<std::string>		ft_vec(words.begin(), words.end());
+		ft::vector<std::string>		ft_copy(ft_vec);
+
+		if (ft_vec.size() != 1000U || ft_vec.capacity() != 1000U || ft_copy.capacity() != 1000U ||
+			!std::equal(ft_vec.begin(), ft_vec.end(), words.begin()) || ft_copy != ft_vec)
+			return KO;
+		ft_copy.assign(ft_vec.begin(), ft_vec.begin() + 10);
+		if (ft_copy.size() != 10U || ft_copy.capacity() != 1000U || ft_copy[9] != ft_vec[9])
+			return KO;
+		ft_copy.assign(ft_vec.begin(), ft_vec.begin() + 500);
+		ft_copy.push_back("x");
+		ft_copy.assign(words.begin(), words.end());
+		words.push_back("last");
+		ft_copy.assign(words.begin(), words.end());
+		if (ft_copy.size() != 1001U || ft_copy.capacity() != 1001U || ft_copy.back() != "last" || ft_copy[500] != ft_vec[500])
+			return KO;
+		ft_vec = ft_copy;
+		if (ft_vec != ft_copy || ft_vec.capacity() != 1001U)
+			return KO;
+
+		// input ranges grow as they are read
+		ft::vector<std::string>		ft_words((std::istream_iterator<std::string>(input)), std::istream_iterator<std::string>());
+
+		if (ft_words.size() != 5U || ft_words[0] != "one" || ft_words[4] != "five")
+			return KO;
+
+		// an unqualified distance, with std in scope, is not ambiguous
+		{
+			using namespace std;
+
+			if (distance(ft_words.begin(), ft_words.end()) != 5)
+				return KO;
+		}
+	}
+	catch (std::exception const &e)
+	{
+		std::cerr << "Exception: " << e.what() << '\n';
+		return KO;
+	}
+	return IMP_OK;
+}
+
 inline static int	__test_function_push_back(void)
 {
 	int		ret;
@@ -3246,13 +3549,18 @@ int	test_vector(void)
 		__test_function_insert_fill,
 		__test_function_insert_range,
 		__test_function_insert_single,
+		__test_function_insert_in_place,
 		__test_function_erase_range,
 		__test_function_erase_single,
+		__test_function_erase_elements,
+		__test_function_trivial_elements,
+		__test_function_relocation,
 		__test_function_push_back,
 		__test_function_pop_back,
 		__test_function_clear,
 		__test_function_assign_fill,
 		__test_function_assign_range,
+		__test_function_exact_size_ranges,
 		__test_function_swap_member,
 		__test_function_swap_non_member,
 		__test_function_reserve,